@@ -0,0 +1,671 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "model/graph.h"
+#include "service/parser.h"
+#include "service/pbf_parser.h"
+#include "service/pathfinder.h"
+#include "service/landmarks.h"
+#include "service/deltastep.h"
+#include "service/autocomplete.h"
+#include "service/overlay.h"
+#include "service/alternatives.h"
+#include "utils/cpu.h"
+#include "utils/threadpool.h"
+#include "utils/geometry.h"
+#include "utils/timer.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+// Mjerenje performansi i provjere tacnosti pojedinih dijelova programa.
+// Upotreba: ./bench <mod> [argumenti]
+
+// pseudo-slucajni broj u [lo, hi)
+static double randRange(double lo, double hi) {
+    return lo + (hi - lo) * (rand() / (RAND_MAX + 1.0));
+}
+
+// Beograd (44.8N, 20.46E): granice APPROX_ERROR_* iz geometry.h vaze za ove oblasti
+#define BELGRADE_LAT 44.8
+#define BELGRADE_LON 20.46
+
+enum { REGION_CIRCLE, REGION_BOX, REGION_SEGMENT };
+
+// par tacaka u krugu od 0.5 stepeni, kvadratu +-0.5 stepeni ili segment ulice (< 1km)
+static void sampleBelgrade(int region, double *lat1, double *lon1, double *lat2, double *lon2) {
+    double p[4];
+    for (int k = 0; k < 4; k += 2) {
+        do {
+            p[k] = randRange(-0.5, 0.5);
+            p[k + 1] = randRange(-0.5, 0.5);
+        } while (region == REGION_CIRCLE && p[k] * p[k] + p[k + 1] * p[k + 1] > 0.25);
+    }
+    if (region == REGION_SEGMENT) {
+        double angle = randRange(0, 2 * M_PI), len = randRange(0, 0.009);
+        p[2] = p[0] + len * sin(angle);
+        p[3] = p[1] + len * cos(angle) / cos(BELGRADE_LAT * M_PI / 180);
+    }
+    *lat1 = BELGRADE_LAT + p[0];
+    *lon1 = BELGRADE_LON + p[1];
+    *lat2 = BELGRADE_LAT + p[2];
+    *lon2 = BELGRADE_LON + p[3];
+}
+
+// najveca relativna greska (parovi krace od 1m se preskacu)
+static double maxRelativeError(const double *ref, const double *out, int n) {
+    double maxRel = 0;
+    for (int i = 0; i < n; i++) {
+        if (ref[i] < 1) continue;
+        double rel = fabs(out[i] - ref[i]) / ref[i];
+        if (rel > maxRel) maxRel = rel;
+    }
+    return maxRel;
+}
+
+// Poredi vektorski haversinus i ekvirektangularnu aproksimaciju sa calculateDistance
+static int benchGeometry(void) {
+    const int n = 1000000;
+    double *lat1 = (double*) malloc(n * sizeof(double));
+    double *lon1 = (double*) malloc(n * sizeof(double));
+    double *lat2 = (double*) malloc(n * sizeof(double));
+    double *lon2 = (double*) malloc(n * sizeof(double));
+    double *ref = (double*) malloc(n * sizeof(double));
+    double *out = (double*) malloc(n * sizeof(double));
+
+    // 1. tacnost na cijeloj zemaljskoj kugli
+    srand(1);
+    for (int i = 0; i < n; i++) {
+        lat1[i] = randRange(-90, 90);
+        lon1[i] = randRange(-180, 180);
+        lat2[i] = randRange(-90, 90);
+        lon2[i] = randRange(-180, 180);
+    }
+    for (int i = 0; i < n; i++) ref[i] = calculateDistance(lat1[i], lon1[i], lat2[i], lon2[i]);
+    calculateDistanceBatch(lat1, lon1, lat2, lon2, out, n);
+    double maxAbs = 0;
+    for (int i = 0; i < n; i++) {
+        double err = fabs(out[i] - ref[i]);
+        if (err > maxAbs) maxAbs = err;
+    }
+    printf("Haversinus (batch), globalno:   max greska %.3e m\n", maxAbs);
+
+    // 2. tacnost i brzina u Beogradu (+-0.25 stepeni)
+    for (int i = 0; i < n; i++) {
+        lat1[i] = randRange(44.55, 45.05);
+        lon1[i] = randRange(20.2, 20.7);
+        lat2[i] = randRange(44.55, 45.05);
+        lon2[i] = randRange(20.2, 20.7);
+    }
+
+    double t0 = nowMs();
+    for (int i = 0; i < n; i++) ref[i] = calculateDistance(lat1[i], lon1[i], lat2[i], lon2[i]);
+    double tScalar = nowMs() - t0;
+
+    t0 = nowMs();
+    calculateDistanceBatch(lat1, lon1, lat2, lon2, out, n);
+    double tBatch = nowMs() - t0;
+
+    double maxRel = maxRelativeError(ref, out, n);
+    printf("Haversinus (batch), Beograd:    max relativna greska %.3e\n", maxRel);
+    int failed = maxRel >= 1e-9;
+
+    t0 = nowMs();
+    approximateDistanceBatch(lat1, lon1, lat2, lon2, out, n);
+    double tApprox = nowMs() - t0;
+
+    printf("Ekvirektangularna, Beograd:     max relativna greska %.3e\n", maxRelativeError(ref, out, n));
+
+    printf("\n%d parova:\n", n);
+    printf("  calculateDistance:        %8.2f ms\n", tScalar);
+    printf("  calculateDistanceBatch:   %8.2f ms (%.1fx)\n", tBatch, tScalar / tBatch);
+    printf("  approximateDistanceBatch: %8.2f ms (%.1fx)\n", tApprox, tScalar / tApprox);
+
+    // 3. granice greske aproksimacije navedene u geometry.h
+    const char *regionNames[] = {"krug 0.5 stepeni", "kvadrat +-0.5", "segmenti < 1km"};
+    const double bounds[] = {APPROX_ERROR_CIRCLE, APPROX_ERROR_BOX, APPROX_ERROR_SEGMENT};
+    printf("\nEkvirektangularna naspram granica iz geometry.h:\n");
+    for (int region = REGION_CIRCLE; region <= REGION_SEGMENT; region++) {
+        for (int i = 0; i < n; i++) sampleBelgrade(region, &lat1[i], &lon1[i], &lat2[i], &lon2[i]);
+        for (int i = 0; i < n; i++) ref[i] = calculateDistance(lat1[i], lon1[i], lat2[i], lon2[i]);
+        approximateDistanceBatch(lat1, lon1, lat2, lon2, out, n);
+        maxRel = maxRelativeError(ref, out, n);
+        int ok = maxRel < bounds[region];
+        printf("  %-18s max %.3e (granica %.1e) %s\n", regionNames[region], maxRel, bounds[region], ok ? "OK" : "PREKORACENA");
+        if (!ok) failed = 1;
+    }
+
+    free(lat1); free(lon1); free(lat2); free(lon2); free(ref); free(out);
+    return failed;
+}
+
+static Graph* loadBenchGraph(const char *filename) {
+    Graph *g = createGraph(100000);
+    double t0 = nowMs();
+    if (!g || loadMap(filename, g) != 0) {
+        freeGraph(g);
+        return NULL;
+    }
+    printf("Graf ucitan za %.1f ms. Cvorova: %d, ivica: %d\n", nowMs() - t0, g->numNodes, g->numEdges);
+    return g;
+}
+
+// nasumicni cvor koji je dio putne mreze
+static int randomRoadNode(Graph *g) {
+    while (1) {
+        int v = rand() % g->numNodes;
+        if (nodeHasEdges(g, v)) return v;
+    }
+}
+
+// Poredi Dijkstru i ALT na nasumicnim upitima
+static int benchLandmarks(const char *filename, int k, int queries) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+
+    double t0 = nowMs();
+    Landmarks *lm = buildLandmarks(g, k);
+    if (!lm) {
+        freeGraph(g);
+        return 1;
+    }
+    printf("%d orijentira izracunato za %.1f ms (%.1f MB)\n", k, nowMs() - t0,
+           (double) k * g->numNodes * sizeof(float) * (lm->toDist == lm->fromDist ? 1 : 2) / (1024 * 1024));
+
+    srand(7);
+    double timeDijkstra = 0, timeAlt = 0;
+    long long settledDijkstra = 0, settledAlt = 0;
+    int mismatches = 0;
+    for (int q = 0; q < queries; q++) {
+        long long s = g->nodes[randomRoadNode(g)].id;
+        long long t = g->nodes[randomRoadNode(g)].id;
+
+        t0 = nowMs();
+        PathResult a = findShortestPath(g, s, t);
+        timeDijkstra += nowMs() - t0;
+
+        t0 = nowMs();
+        PathResult b = findShortestPathALT(g, lm, s, t, NULL);
+        timeAlt += nowMs() - t0;
+
+        settledDijkstra += a.settledNodes;
+        settledAlt += b.settledNodes;
+        if (fabs(a.distance - b.distance) > 1e-6 * (a.distance > 1 ? a.distance : 1)) mismatches++;
+        freePathResult(a);
+        freePathResult(b);
+    }
+
+    printf("\n%d upita:\n", queries);
+    printf("  Dijkstra: %8.3f ms/upit, %8lld obradjenih cvorova/upit\n", timeDijkstra / queries, settledDijkstra / queries);
+    printf("  ALT (%2d): %8.3f ms/upit, %8lld obradjenih cvorova/upit\n", k, timeAlt / queries, settledAlt / queries);
+    printf("  Razlicitih duzina: %d\n", mismatches);
+
+    freeLandmarks(lm);
+    freeGraph(g);
+    return mismatches != 0;
+}
+
+// Skaliranje paralelnog delta-stepping SSSP-a po broju niti, uz provjeru prema Dijkstri
+static int benchSSSP(const char *filename, int maxThreads, int sources, double delta) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+
+    int *src = (int*) malloc(sources * sizeof(int));
+    double *refDist = (double*) malloc((size_t) sources * g->numNodes * sizeof(double));
+    int *refParent = (int*) malloc((size_t) sources * g->numNodes * sizeof(int));
+    srand(11);
+    for (int i = 0; i < sources; i++) src[i] = randomRoadNode(g);
+
+    double t0 = nowMs();
+    for (int i = 0; i < sources; i++) {
+        computeShortestPathTree(g, src[i]);
+        memcpy(refDist + (size_t) i * g->numNodes, g->dist, g->numNodes * sizeof(double));
+        memcpy(refParent + (size_t) i * g->numNodes, g->parent, g->numNodes * sizeof(int));
+    }
+    double tDijkstra = (nowMs() - t0) / sources;
+    printf("\n%d izvora, %d procesora\n", sources, cpuCount());
+    printf("  Dijkstra (binarni heap): %8.2f ms/izvor\n", tDijkstra);
+
+    int failed = 0;
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool *pool = createThreadPool(threads);
+        int distDiff = 0, parentDiff = 0;
+
+        t0 = nowMs();
+        for (int i = 0; i < sources; i++) {
+            computeShortestPathTreeParallel(g, pool, src[i], delta);
+            for (int v = 0; v < g->numNodes; v++) {
+                if (g->dist[v] != refDist[(size_t) i * g->numNodes + v]) distDiff++;
+                if (g->parent[v] != refParent[(size_t) i * g->numNodes + v]) parentDiff++;
+            }
+        }
+        double t = (nowMs() - t0) / sources;
+        printf("  delta-stepping, %2d niti: %8.2f ms/izvor (%.2fx), razlika udaljenosti: %d, roditelja: %d\n",
+               threads, t, tDijkstra / t, distDiff, parentDiff);
+        if (distDiff || parentDiff) failed = 1;
+        freeThreadPool(pool);
+    }
+
+    free(src);
+    free(refDist);
+    free(refParent);
+    freeGraph(g);
+    return failed;
+}
+
+// brojac promasaja kesa (Linux perf_event); -1 ako nije dostupan
+static int openCacheMissCounter(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int) syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void startCounter(int fd) {
+#ifdef __linux__
+    if (fd < 0) return;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+static long long stopCounter(int fd) {
+#ifdef __linux__
+    long long count = -1;
+    if (fd < 0) return -1;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, &count, sizeof(count)) != sizeof(count)) return -1;
+    return count;
+#else
+    return -1;
+#endif
+}
+
+static void runReorderQueries(Graph *g, const char *label, long long *pairs, int queries, int counter) {
+    double total = 0;
+    startCounter(counter);
+    double t0 = nowMs();
+    for (int q = 0; q < queries; q++) {
+        PathResult r = findShortestPath(g, pairs[2 * q], pairs[2 * q + 1]);
+        total += r.distance;
+        freePathResult(r);
+    }
+    double t = nowMs() - t0;
+    long long misses = stopCounter(counter);
+
+    printf("  %-22s %8.3f ms/upit", label, t / queries);
+    if (misses >= 0) printf(", %10lld promasaja kesa/upit", misses / queries);
+    else printf(", promasaji kesa: n/a");
+    printf(" (zbir duzina %.1f)\n", total);
+}
+
+// Vrijeme upita i promasaji kesa prije i poslije preslagivanja cvorova
+static int benchReorder(const char *filename, int queries) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+
+    long long *pairs = (long long*) malloc(2 * queries * sizeof(long long));
+    srand(13);
+    for (int q = 0; q < 2 * queries; q++) pairs[q] = g->nodes[randomRoadNode(g)].id;
+
+    int counter = openCacheMissCounter();
+    printf("\n%d upita (Dijkstra):\n", queries);
+    runReorderQueries(g, "redoslijed iz fajla", pairs, queries, counter);
+
+    double t0 = nowMs();
+    reorderGraph(g, ORDER_BFS);
+    printf("  (BFS preslagivanje: %.1f ms)\n", nowMs() - t0);
+    runReorderQueries(g, "BFS", pairs, queries, counter);
+
+    t0 = nowMs();
+    reorderGraph(g, ORDER_HILBERT);
+    printf("  (Hilbert preslagivanje: %.1f ms)\n", nowMs() - t0);
+    runReorderQueries(g, "Hilbert", pairs, queries, counter);
+
+#ifdef __linux__
+    if (counter >= 0) close(counter);
+#endif
+    free(pairs);
+    freeGraph(g);
+    return 0;
+}
+
+// Dopune po prefiksu iz rjecnika imena naspram pretrage podstringa kroz cijeli graf
+static int benchAutocomplete(const char *filename, int queries) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+
+    double t0 = nowMs();
+    NameIndex *idx = buildNameIndex(g);
+    printf("Rjecnik imena: %d unosa, izgradnja %.1f ms\n", idx->numEntries, nowMs() - t0);
+    if (idx->numEntries == 0) {
+        freeNameIndex(idx);
+        freeGraph(g);
+        return 0;
+    }
+
+    // prefiksi duzine 1-6 uzeti iz nasumicnih imena iz rjecnika ("kucanje" slovo po slovo)
+    char (*prefixes)[8] = malloc(queries * sizeof(*prefixes));
+    srand(17);
+    for (int q = 0; q < queries; q++) {
+        const char *name = idx->entries[rand() % idx->numEntries].name;
+        size_t len = 1 + q % 6;
+        if (len > strlen(name)) len = strlen(name);
+        memcpy(prefixes[q], name, len);
+        prefixes[q][len] = '\0';
+    }
+
+    const NameEntry *out[10];
+    long found = 0;
+    t0 = nowMs();
+    for (int q = 0; q < queries; q++) found += completePrefix(idx, prefixes[q], 10, out);
+    double tIndex = nowMs() - t0;
+
+    long matches = 0;
+    t0 = nowMs();
+    for (int q = 0; q < queries; q++) {
+        int count = 0;
+        Node **r = findNodesByName(g, prefixes[q], &count);
+        matches += count;
+        free(r);
+    }
+    double tScan = nowMs() - t0;
+
+    printf("%d prefiksa:\n", queries);
+    printf("  rjecnik (top 10):   %8.2f us/upit (%ld prijedloga)\n", 1000 * tIndex / queries, found);
+    printf("  podstring (graf):   %8.2f us/upit (%ld cvorova)\n", 1000 * tScan / queries, matches);
+
+    free(prefixes);
+    freeNameIndex(idx);
+    freeGraph(g);
+    return 0;
+}
+
+// duzina putanje sabrana po ivicama iz pathEdges (-1 ako ivica ne spaja uzastopne cvorove)
+static double walkPath(Graph *g, PathResult *r) {
+    double total = 0;
+    for (int i = 1; i < r->pathLength; i++) {
+        int u = findNodeIndex(g, r->pathNodes[i - 1]);
+        int v = findNodeIndex(g, r->pathNodes[i]);
+        int k = r->pathEdges[i];
+        int found = 0;
+        for (int j = g->firstEdge[u]; j != -1 && !found; j = g->edges[j].next) found = j == k;
+        if (!found || g->edges[k].target != v) return -1;
+        total += edgeWeight(&g->edges[k]);
+    }
+    return total;
+}
+
+// vraca broj upita cija se duzina ili putanja ne slaze sa Dijkstrom
+static int runOverlayQueries(Graph *g, Overlay *ov, long long *pairs, int queries, const char *label) {
+    double time = 0;
+    long long settled = 0;
+    int mismatches = 0;
+    ov->cacheHits = ov->cacheMisses = 0;
+    for (int q = 0; q < queries; q++) {
+        PathResult a = findShortestPath(g, pairs[2 * q], pairs[2 * q + 1]);
+
+        double t0 = nowMs();
+        PathResult b = findShortestPathOverlay(g, ov, pairs[2 * q], pairs[2 * q + 1], NULL);
+        time += nowMs() - t0;
+        settled += b.settledNodes;
+
+        // ista duzina kao Dijkstra, a raspakovana putanja zaista ima tu duzinu
+        double eps = 1e-6 * (a.distance > 1 ? a.distance : 1);
+        if (fabs(a.distance - b.distance) > eps) mismatches++;
+        else if (b.pathLength > 0 && fabs(walkPath(g, &b) - b.distance) > eps) mismatches++;
+        freePathResult(a);
+        freePathResult(b);
+    }
+    printf("  %-18s %8.3f ms/upit, %8lld obradjenih cvorova/upit, kes %ld/%ld pogodaka, %.1f MB, gresaka: %d\n",
+           label, time / queries, settled / queries, ov->cacheHits, ov->cacheHits + ov->cacheMisses,
+           ov->usedBytes / (1024.0 * 1024.0), mismatches);
+    return mismatches;
+}
+
+// Izgradnja overlay-a, poredjenje sa Dijkstrom i rad sa malim kesom matrica
+static int benchOverlay(const char *filename, int levels, int queries, double cacheMB) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+    reorderGraph(g, ORDER_HILBERT);
+
+    char path[1024];
+    snprintf(path, sizeof(path), "%s.crp", filename);
+    double t0 = nowMs();
+    Overlay *ov = buildOverlay(g, path, levels, 0, 0);
+    if (!ov) {
+        freeGraph(g);
+        return 1;
+    }
+    printf("Overlay (%d nivoa) izgradjen za %.1f ms\n", ov->numLevels, nowMs() - t0);
+    for (int l = 1; l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        int b = lv->boundaryStart[lv->numCells];
+        printf("  nivo %d: %6d celija, %7d granicnih cvorova\n", l, lv->numCells, b);
+    }
+    freeOverlay(ov);
+
+    long long *pairs = (long long*) malloc(2 * queries * sizeof(long long));
+    srand(11);
+    for (int q = 0; q < 2 * queries; q++) pairs[q] = g->nodes[randomRoadNode(g)].id;
+
+    double timeDijkstra = 0;
+    long long settledDijkstra = 0;
+    for (int q = 0; q < queries; q++) {
+        t0 = nowMs();
+        PathResult r = findShortestPath(g, pairs[2 * q], pairs[2 * q + 1]);
+        timeDijkstra += nowMs() - t0;
+        settledDijkstra += r.settledNodes;
+        freePathResult(r);
+    }
+    printf("\n%d upita:\n", queries);
+    printf("  %-18s %8.3f ms/upit, %8lld obradjenih cvorova/upit\n", "Dijkstra", timeDijkstra / queries, settledDijkstra / queries);
+
+    ov = loadOverlay(g, path, 0);
+    if (!ov) {
+        printf("Greska: overlay se ne moze ucitati iz %s\n", path);
+        free(pairs);
+        freeGraph(g);
+        return 1;
+    }
+    int mismatches = runOverlayQueries(g, ov, pairs, queries, "overlay");
+    freeOverlay(ov);
+
+    ov = loadOverlay(g, path, (size_t) (cacheMB * 1024 * 1024));
+    if (ov) {
+        char label[64];
+        snprintf(label, sizeof(label), "overlay (kes %.1f MB)", cacheMB);
+        mismatches += runOverlayQueries(g, ov, pairs, queries, label);
+        freeOverlay(ov);
+    }
+    else {
+        printf("Greska: overlay se ne moze ucitati iz %s\n", path);
+        mismatches++;
+    }
+
+    free(pairs);
+    freeGraph(g);
+    return mismatches != 0;
+}
+
+// Alternativne rute: cijena prema jednoj Dijkstri i provjera svake rute
+// (duzina po ivicama, granica produzenja, najkraca ruta jednaka Dijkstri)
+static int benchAlternatives(const char *filename, int k, int queries) {
+    Graph *g = loadBenchGraph(filename);
+    if (!g) return 1;
+    reorderGraph(g, ORDER_HILBERT);
+    ReverseAdjacency *reverse = createReverseAdjacency(g);
+
+    AlternativeOptions opt;
+    defaultAlternativeOptions(&opt);
+    opt.maxRoutes = k;
+    PathResult *routes = (PathResult*) malloc(k * sizeof(PathResult));
+
+    double timeDijkstra = 0, timeAlternatives = 0;
+    long long settledDijkstra = 0, settledAlternatives = 0;
+    int totalRoutes = 0, withAlternative = 0, errors = 0;
+    srand(13);
+    for (int q = 0; q < queries; q++) {
+        long long s = g->nodes[randomRoadNode(g)].id;
+        long long t = g->nodes[randomRoadNode(g)].id;
+
+        double t0 = nowMs();
+        PathResult a = findShortestPath(g, s, t);
+        timeDijkstra += nowMs() - t0;
+        settledDijkstra += a.settledNodes;
+
+        t0 = nowMs();
+        int found = findAlternativeRoutes(g, reverse, s, t, &opt, NULL, routes);
+        timeAlternatives += nowMs() - t0;
+        settledAlternatives += routes[0].settledNodes;
+
+        if ((found > 0) != (a.distance != -1)) errors++;
+        for (int i = 0; i < found; i++) {
+            double eps = 1e-6 * (a.distance > 1 ? a.distance : 1);
+            double len = walkPath(g, &routes[i]);
+            if (fabs(len - routes[i].distance) > eps) errors++;
+            if (i == 0 && fabs(routes[0].distance - a.distance) > eps) errors++;
+            if (routes[i].distance > opt.maxStretch * a.distance + eps) errors++;
+            freePathResult(routes[i]);
+        }
+        totalRoutes += found;
+        if (found > 1) withAlternative++;
+        freePathResult(a);
+    }
+
+    printf("%d upita, do %d ruta:\n", queries, k);
+    printf("  Dijkstra:     %8.3f ms/upit, %8lld obradjenih cvorova/upit\n",
+           timeDijkstra / queries, settledDijkstra / queries);
+    printf("  alternative:  %8.3f ms/upit, %8lld obradjenih cvorova/upit (%.2fx)\n",
+           timeAlternatives / queries, settledAlternatives / queries, timeAlternatives / timeDijkstra);
+    printf("  ruta po upitu: %.2f, upita sa alternativom: %d, gresaka: %d\n",
+           (double) totalRoutes / queries, withAlternative, errors);
+
+    free(routes);
+    freeReverseAdjacency(reverse);
+    freeGraph(g);
+    return errors != 0;
+}
+
+// Razlike izmedju dva grafa: broj cvorova i ivica, kontrolna suma,
+// koordinate cvorova i imena ulica na ivicama
+static int compareGraphs(Graph *a, Graph *b, const char *label) {
+    uint64_t ca = graphChecksum(a), cb = graphChecksum(b);
+    printf("  %-22s cvorova %d, ivica %d, kontrolna suma %016llx\n", label, b->numNodes, b->numEdges,
+           (unsigned long long) cb);
+    if (a->numNodes != b->numNodes || a->numEdges != b->numEdges || ca != cb) {
+        printf("Greska: %s se razlikuje od XML grafa\n", label);
+        return 1;
+    }
+
+    int diffs = 0;
+    for (int i = 0; i < a->numNodes; i++) {
+        if (a->lat[i] != b->lat[i] || a->lon[i] != b->lon[i]) diffs++;
+    }
+    for (int k = 0; k < a->numEdges; k++) {
+        int na = a->edgeNameIds[k], nb = b->edgeNameIds[k];
+        const char *sa = na >= 0 ? a->names[na] : "";
+        const char *sb = nb >= 0 ? b->names[nb] : "";
+        if (strcmp(sa, sb) != 0) diffs++;
+    }
+    if (diffs) printf("Greska: %s ima %d razlika u koordinatama ili imenima\n", label, diffs);
+    return diffs != 0;
+}
+
+// PBF parser mora dati isti graf kao XML parser za isti sadrzaj
+// (i kad se blokovi ucitavaju jedan po jedan)
+static int benchPbf(const char *xmlFile, const char *pbfFile) {
+    Graph *ref = createGraph(100000);
+    double t0 = nowMs();
+    if (!ref || parseMap(xmlFile, ref) != 0) {
+        freeGraph(ref);
+        return 1;
+    }
+    printf("XML ucitan za %.1f ms\n", nowMs() - t0);
+    printf("  %-22s cvorova %d, ivica %d, kontrolna suma %016llx\n", "XML", ref->numNodes, ref->numEdges,
+           (unsigned long long) graphChecksum(ref));
+
+    int failed = 0;
+    int batches[2] = {0, 1};
+    for (int i = 0; i < 2; i++) {
+        Graph *g = createGraph(100000);
+        t0 = nowMs();
+        if (!g || parsePbfMapBatched(pbfFile, g, batches[i]) != 0) {
+            failed++;
+        }
+        else {
+            printf("PBF ucitan za %.1f ms\n", nowMs() - t0);
+            failed += compareGraphs(ref, g, batches[i] ? "PBF (blok po blok)" : "PBF");
+        }
+        freeGraph(g);
+    }
+
+    freeGraph(ref);
+    return failed != 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Upotreba: %s geometry\n", argv[0]);
+        printf("          %s alt <mapa> [broj_orijentira] [broj_upita]\n", argv[0]);
+        printf("          %s sssp <mapa> [max_niti] [broj_izvora] [delta_metara]\n", argv[0]);
+        printf("          %s reorder <mapa> [broj_upita]\n", argv[0]);
+        printf("          %s complete <mapa> [broj_upita]\n", argv[0]);
+        printf("          %s crp <mapa> [broj_nivoa] [broj_upita] [kes_MB]\n", argv[0]);
+        printf("          %s routes <mapa> [broj_ruta] [broj_upita]\n", argv[0]);
+        printf("          %s pbf <mapa.osm> <mapa.osm.pbf>\n", argv[0]);
+        return 1;
+    }
+
+    if (strcmp(argv[1], "geometry") == 0) {
+        return benchGeometry();
+    }
+    if (strcmp(argv[1], "alt") == 0 && argc >= 3) {
+        int k = argc >= 4 ? atoi(argv[3]) : 8;
+        int queries = argc >= 5 ? atoi(argv[4]) : 100;
+        return benchLandmarks(argv[2], k, queries);
+    }
+    if (strcmp(argv[1], "sssp") == 0 && argc >= 3) {
+        int maxThreads = argc >= 4 ? atoi(argv[3]) : cpuCount();
+        int sources = argc >= 5 ? atoi(argv[4]) : 10;
+        double delta = argc >= 6 ? atof(argv[5]) : 0;
+        return benchSSSP(argv[2], maxThreads, sources, delta);
+    }
+    if (strcmp(argv[1], "reorder") == 0 && argc >= 3) {
+        return benchReorder(argv[2], argc >= 4 ? atoi(argv[3]) : 100);
+    }
+    if (strcmp(argv[1], "complete") == 0 && argc >= 3) {
+        return benchAutocomplete(argv[2], argc >= 4 ? atoi(argv[3]) : 1000);
+    }
+    if (strcmp(argv[1], "crp") == 0 && argc >= 3) {
+        int levels = argc >= 4 ? atoi(argv[3]) : 3;
+        int queries = argc >= 5 ? atoi(argv[4]) : 100;
+        double cacheMB = argc >= 6 ? atof(argv[5]) : 0.5;
+        return benchOverlay(argv[2], levels, queries, cacheMB);
+    }
+    if (strcmp(argv[1], "routes") == 0 && argc >= 3) {
+        int k = argc >= 4 ? atoi(argv[3]) : ALTERNATIVES_DEFAULT_ROUTES;
+        int queries = argc >= 5 ? atoi(argv[4]) : 100;
+        return benchAlternatives(argv[2], k > 0 ? k : 1, queries);
+    }
+    if (strcmp(argv[1], "pbf") == 0 && argc >= 4) {
+        return benchPbf(argv[2], argv[3]);
+    }
+
+    printf("Nepoznat mod: %s\n", argv[1]);
+    return 1;
+}
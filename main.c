@@ -4,13 +4,28 @@
 #include "model/graph.h"
 #include "service/parser.h"
 #include "service/pathfinder.h"
+#include "service/landmarks.h"
+#include "service/autocomplete.h"
+#include "service/overlay.h"
+#include "service/route.h"
+#include "service/alternatives.h"
 #include "utils/geometry.h"
+#include "utils/timer.h"
+#include <signal.h>
+
+// Ctrl+C tokom pretrage otkazuje samo tekuci upit
+static volatile sig_atomic_t cancelQuery = 0;
+
+static void onInterrupt(int sig) {
+    (void) sig;
+    cancelQuery = 1;
+}
 
 // pomocna funkcija za dobijanje ID-a cvora od korisnika (ID ili ime)
-long long getNodeInput(Graph *g, const char *prompt) {
+long long getNodeInput(Graph *g, NameIndex *names, const char *prompt) {
     char input[256];
     while (1) {
-        printf("%s (unesite ID ili Ime): ", prompt);
+        printf("%s (unesite ID, Ime ili pocetak imena sa *): ", prompt);
         if (fgets(input, sizeof(input), stdin) == NULL) return -1;
         input[strcspn(input, "\n")] = 0; // Ukloni novi red
         
@@ -26,6 +41,27 @@ long long getNodeInput(Graph *g, const char *prompt) {
                 printf("Cvor sa ID-em %lld nije pronadjen.\n", id);
             }
         } 
+        else if (strlen(input) > 1 && input[strlen(input) - 1] == '*') {
+            // "Pref*": dopune iz rjecnika imena
+            input[strlen(input) - 1] = '\0';
+            const NameEntry *suggestions[10];
+            int count = completePrefix(names, input, 10, suggestions);
+            if (count == 0) {
+                printf("Nema imena koja pocinju sa '%s'.\n", input);
+                continue;
+            }
+            for (int i = 0; i < count; i++) {
+                printf("%d. %s (%d cvorova)\n", i + 1, suggestions[i]->name, suggestions[i]->nodeCount);
+            }
+            printf("Izaberite broj (1-%d) ili 0 za odustajanje/ponovni unos: ", count);
+            if (fgets(input, sizeof(input), stdin)) {
+                int choice = atoi(input);
+                if (choice >= 1 && choice <= count) {
+                    const NameEntry *e = suggestions[choice - 1];
+                    return g->nodes[names->nodes[e->firstNode]].id;
+                }
+            }
+        }
         else {
             // to je string, pretrazi po imenu
             int count = 0;
@@ -71,6 +107,19 @@ long long getNodeInput(Graph *g, const char *prompt) {
     }
 }
 
+// ispis rute: uzastopne ivice iste ulice se spajaju u deonice
+static void printRoute(Graph *g, PathResult *result) {
+    RouteSummary route = summarizeRoute(g, result);
+    size_t len = formatRoute(g, &route, NULL, 0);
+    char *text = (char*) malloc(len + 1);
+    formatRoute(g, &route, text, len + 1);
+    printf("Putanja (%d deonica, %d cvorova): %s\n", route.numSegments, result->pathLength, text);
+    free(text);
+    freeRouteSummary(route);
+}
+
+#define MAX_ROUTES 8
+
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -81,36 +130,132 @@ int main(int argc, char *argv[]) {
 #endif
     setbuf(stdout, NULL);
     if (argc < 2) {
-        printf("Upotreba: %s <putanja_do_xml_fajla>\n", argv[0]);
+        printf("Upotreba: %s <putanja_do_osm_ili_pbf_fajla> [--alt broj_orijentira] [--order hilbert|bfs|none] [--timeout ms] [--crp broj_nivoa] [--crp-cache MB] [--routes broj_ruta]\n", argv[0]);
         return 1;
     }
 
+    int landmarkCount = 0;
+    NodeOrder order = ORDER_HILBERT;
+    double timeoutMs = 0; // 0 = bez roka
+    int overlayLevels = 0;
+    size_t overlayCacheBytes = OVERLAY_DEFAULT_CACHE_BYTES;
+    int routeCount = 1; // > 1: najkraci put i alternative
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--alt") == 0 && i + 1 < argc) {
+            landmarkCount = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+            order = parseNodeOrder(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc) {
+            timeoutMs = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--crp") == 0 && i + 1 < argc) {
+            overlayLevels = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--crp-cache") == 0 && i + 1 < argc) {
+            overlayCacheBytes = (size_t) (atof(argv[++i]) * 1024 * 1024);
+        }
+        else if (strcmp(argv[i], "--routes") == 0 && i + 1 < argc) {
+            routeCount = atoi(argv[++i]);
+            if (routeCount < 1) routeCount = 1;
+            if (routeCount > MAX_ROUTES) routeCount = MAX_ROUTES;
+        }
+    }
+
+    // alternative koriste samo Dijkstru nad oba stabla, pa se ALT i overlay tada ne prave
+    if (routeCount > 1 && (landmarkCount > 0 || overlayLevels > 0)) {
+        printf("Napomena: --alt i --crp se ne koriste uz --routes i bice zanemareni.\n");
+        landmarkCount = 0;
+        overlayLevels = 0;
+    }
+
     Graph *g = createGraph(100000); // pocetni kapacitet
-    if (parseMap(argv[1], g) != 0) {
+    if (!g || loadMap(argv[1], g) != 0) {
         printf("Neuspesno ucitavanje mape.\n");
         fflush(stdout);
         freeGraph(g);
         return 1;
     }
     
+    // susjedni cvorovi blizu u memoriji => manje promasaja kesa tokom pretrage
+    reorderGraph(g, order);
+
     printf("Graf ucitan. Cvorova: %d\n", g->numNodes);
     fflush(stdout);
 
+    // rjecnik imena za dopunjavanje po prefiksu (gradi se nakon preslagivanja, cuva indekse cvorova)
+    NameIndex *names = buildNameIndex(g);
+
+    // ALT: tabele orijentira se cuvaju pored mape i ponovo koriste ako odgovaraju grafu
+    Landmarks *lm = NULL;
+    if (landmarkCount > 0) {
+        char altPath[1024];
+        snprintf(altPath, sizeof(altPath), "%s.alt", argv[1]);
+        lm = loadLandmarks(g, altPath);
+        if (lm && lm->k != landmarkCount) {
+            freeLandmarks(lm);
+            lm = NULL;
+        }
+        if (lm) {
+            printf("Ucitane tabele orijentira (%d) iz %s\n", lm->k, altPath);
+        }
+        else {
+            printf("Racunanje %d orijentira (ALT)...\n", landmarkCount);
+            lm = buildLandmarks(g, landmarkCount);
+            if (lm && saveLandmarks(g, lm, altPath) == 0) {
+                printf("Tabele orijentira sacuvane u %s\n", altPath);
+            }
+        }
+    }
+
+    // Overlay (particije): matrice celija su u <mapa>.crp i ucitavaju se po potrebi
+    Overlay *ov = NULL;
+    if (overlayLevels > 0) {
+        char crpPath[1024];
+        snprintf(crpPath, sizeof(crpPath), "%s.crp", argv[1]);
+        ov = loadOverlay(g, crpPath, overlayCacheBytes);
+        if (ov && (ov->requestedLevels != overlayLevels || ov->cellSize != OVERLAY_DEFAULT_CELL_SIZE)) {
+            freeOverlay(ov);
+            ov = NULL;
+        }
+        if (ov) {
+            printf("Ucitan overlay (%d nivoa) iz %s\n", ov->numLevels, crpPath);
+        }
+        else {
+            printf("Particionisanje grafa i racunanje overlay-a (%d nivoa)...\n", overlayLevels);
+            ov = buildOverlay(g, crpPath, overlayLevels, 0, overlayCacheBytes);
+            if (ov) printf("Overlay sacuvan u %s\n", crpPath);
+        }
+    }
+
+    // Alternativne rute: stablo do cilja se racuna po obrnutim ivicama (prave se jednom)
+    ReverseAdjacency *reverse = NULL;
+    AlternativeOptions altOptions;
+    defaultAlternativeOptions(&altOptions);
+    altOptions.maxRoutes = routeCount;
+    if (routeCount > 1) {
+        reverse = createReverseAdjacency(g);
+        printf("Alternativne rute: do %d po upitu\n", routeCount);
+    }
+
     while (1) {
         printf("\n--- Pronadji Najkraci Put ---\n");
-        long long startId = getNodeInput(g, "Pocetna Lokacija");
+        long long startId = getNodeInput(g, names, "Pocetna Lokacija");
         if (startId == -1) break;
         
-        long long endId = getNodeInput(g, "Krajnja Lokacija");
+        long long endId = getNodeInput(g, names, "Krajnja Lokacija");
         if (endId == -1) break;
 
         // Provjeri da li je pocetni cvor izolovan
         Node *startNode = findNode(g, startId);
-        if (startNode && startNode->edges == NULL) {
+        if (startNode && !nodeHasEdges(g, nodeIndex(g, startNode))) {
             printf("\nCvor %lld (%s) je izolovan. Povezivanje sa najblizim putem...\n", startId, startNode->name ? startNode->name : "Nepoznato");
-            Node *nearest = getNearestNode(g, startNode->lat, startNode->lon);
+            int startIdx = nodeIndex(g, startNode);
+            Node *nearest = getNearestNode(g, nodeLat(g, startIdx), nodeLon(g, startIdx));
             if (nearest) {
-                printf("Povezano sa cvorom %lld (%.2f metara udaljeno)\n", nearest->id, calculateDistance(startNode->lat, startNode->lon, nearest->lat, nearest->lon));
+                int nearestIdx = nodeIndex(g, nearest);
+                printf("Povezano sa cvorom %lld (%.2f metara udaljeno)\n", nearest->id, calculateDistance(nodeLat(g, startIdx), nodeLon(g, startIdx), nodeLat(g, nearestIdx), nodeLon(g, nearestIdx)));
                 startId = nearest->id;
             } 
             else {
@@ -121,11 +266,13 @@ int main(int argc, char *argv[]) {
 
         // provjeri da li je krajnji cvor izolovan
         Node *endNode = findNode(g, endId);
-        if (endNode && endNode->edges == NULL) {
+        if (endNode && !nodeHasEdges(g, nodeIndex(g, endNode))) {
             printf("\nCvor %lld (%s) je izolovan. Povezivanje sa najblizim putem...\n", endId, endNode->name ? endNode->name : "Nepoznato");
-            Node *nearest = getNearestNode(g, endNode->lat, endNode->lon);
+            int endIdx = nodeIndex(g, endNode);
+            Node *nearest = getNearestNode(g, nodeLat(g, endIdx), nodeLon(g, endIdx));
             if (nearest) {
-                printf("Povezano sa cvorom %lld (%.2f metara udaljeno)\n", nearest->id, calculateDistance(endNode->lat, endNode->lon, nearest->lat, nearest->lon));
+                int nearestIdx = nodeIndex(g, nearest);
+                printf("Povezano sa cvorom %lld (%.2f metara udaljeno)\n", nearest->id, calculateDistance(nodeLat(g, endIdx), nodeLon(g, endIdx), nodeLat(g, nearestIdx), nodeLon(g, nearestIdx)));
                 endId = nearest->id;
             }
             else {
@@ -134,50 +281,58 @@ int main(int argc, char *argv[]) {
             }
         }
 
-        PathResult result = findShortestPath(g, startId, endId);
+        // rok po upitu; ako istekne, vraca se djelimicna putanja i procjena ostatka
+        SearchLimits limits = {0};
+        limits.deadlineMs = timeoutMs > 0 ? nowMs() + timeoutMs : 0;
+        limits.cancel = &cancelQuery;
+        limits.fallback = FALLBACK_PARTIAL;
+
+        cancelQuery = 0;
+        signal(SIGINT, onInterrupt);
+        PathResult routes[MAX_ROUTES];
+        int found;
+        if (reverse) {
+            found = findAlternativeRoutes(g, reverse, startId, endId, &altOptions, &limits, routes);
+        }
+        else {
+            routes[0] = ov ? findShortestPathOverlay(g, ov, startId, endId, &limits)
+                      : lm ? findShortestPathALT(g, lm, startId, endId, &limits)
+                           : findShortestPathLimited(g, startId, endId, NULL, NULL, &limits);
+            found = routes[0].distance == -1 ? 0 : 1;
+        }
+        signal(SIGINT, SIG_DFL);
+
+        PathResult *result = &routes[0];
+        if (result->status == PATH_TIMEOUT || result->status == PATH_CANCELLED) {
+            printf("\nPretraga prekinuta (%s) nakon %d obradjenih cvorova.\n",
+                   result->status == PATH_TIMEOUT ? "isteklo vrijeme" : "otkazana", result->settledNodes);
+        }
 
-        if (result.distance == -1) {
-            printf("\nNije pronadjen put izmedju %lld i %lld.\n", startId, endId);
+        if (found == 0) {
+            if (result->status == PATH_NOT_FOUND) {
+                printf("\nNije pronadjen put izmedju %lld i %lld.\n", startId, endId);
+            }
+            else if (result->status == PATH_IO_ERROR) {
+                printf("\nGreska pri citanju overlay podataka; put nije izracunat.\n");
+            }
         } 
         else {
-            printf("\nDuzina najkraceg puta: %.2f metara\n", result.distance);
-            printf("Putanja: ");
-            for (int i = 0; i < result.pathLength; i++) {
-                Node *n = findNode(g, result.pathNodes[i]);
-                if (n && n->name) {
-                    printf("%s", n->name);
-                } 
-                else {
-                    // Ako cvor nema ime, pokusavamo pronaci ime ulice koja vodi do njega
-                    char *edgeName = NULL;
-                    if (i > 0) {
-                        Node *prev = findNode(g, result.pathNodes[i-1]);
-                        if (prev) {
-                            Edge *e = prev->edges;
-                            while (e) {
-                                if (e->targetNodeId == result.pathNodes[i]) {
-                                    if (e->name && strlen(e->name) > 0) {
-                                        edgeName = e->name;
-                                    }
-                                    break;
-                                }
-                                e = e->next;
-                            }
-                        }
-                    }
-                    
-                    if (edgeName) {
-                        printf("%s", edgeName);
-                    } 
-                    else {
-                        printf("%lld", result.pathNodes[i]);
-                    }
-                }
-                
-                if (i < result.pathLength - 1) printf(" -> ");
+            if (result->estimate == FALLBACK_PARTIAL) {
+                printf("Procjena duzine puta: %.2f metara (djelimicna putanja + vazdusna linija do cilja)\n", result->distance);
+            }
+            else if (result->estimate == FALLBACK_STRAIGHT_LINE) {
+                printf("Procjena duzine puta: %.2f metara (vazdusna linija od starta do cilja)\n", result->distance);
+            }
+            else {
+                printf("\nDuzina najkraceg puta: %.2f metara\n", result->distance);
+            }
+            if (result->pathLength > 0) printRoute(g, result);
+            for (int i = 1; i < found; i++) {
+                printf("\nAlternativa %d: %.2f metara (+%.1f%%)\n", i, routes[i].distance,
+                       100 * (routes[i].distance / result->distance - 1));
+                printRoute(g, &routes[i]);
             }
-            printf("\n");
-            freePathResult(result);
+            for (int i = 0; i < found; i++) freePathResult(routes[i]);
         }
         
         printf("\nPronadji drugi put? (d/n): ");
@@ -187,6 +342,10 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    freeLandmarks(lm);
+    freeOverlay(ov);
+    freeReverseAdjacency(reverse);
+    freeNameIndex(names);
     freeGraph(g);
     return 0;
 }
@@ -2,124 +2,178 @@
 #include "graph.h"
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
+#include <limits.h>
 #include "../utils/levenstajn.h"
+#include "../utils/geometry.h"
+#include "../utils/normalize.h"
 
 #define HASH_SIZE 10007 // prost broj za velicinu hes tabele
 
+// prosiruje niz na count elemenata; ako realloc ne uspije, stari niz ostaje vazeci
+#define GROW_ARRAY(arr, count) do { \
+        void *grown = realloc((arr), (size_t) (count) * sizeof(*(arr))); \
+        if (!grown) return -1; \
+        (arr) = grown; \
+    } while (0)
+
 Graph* createGraph(int capacity) {
-    Graph *g = (Graph*) malloc(sizeof(Graph));
+    Graph *g = (Graph*) calloc(1, sizeof(Graph));
+    if (!g) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za graf\n");
+        return NULL;
+    }
+    if (capacity < 16) capacity = 16;
     g->numNodes = 0;
     g->capacity = capacity;
-    g->nodes = NULL;
-    
-    // Alociraj hes mapu
-    g->nodeMap = (Node**) calloc(HASH_SIZE, sizeof(Node*));
-    if (!g->nodeMap) {
-        fprintf(stderr, "Error: Failed to allocate nodeMap\n");
-        free(g);
+
+    g->nodes = (Node*) malloc(capacity * sizeof(Node));
+    g->hashNext = (int*) malloc(capacity * sizeof(int));
+    g->lat = (int32_t*) malloc(capacity * sizeof(int32_t));
+    g->lon = (int32_t*) malloc(capacity * sizeof(int32_t));
+    g->firstEdge = (int*) malloc(capacity * sizeof(int));
+    g->dist = (double*) malloc(capacity * sizeof(double));
+    g->visited = (unsigned char*) malloc(capacity * sizeof(unsigned char));
+    g->parent = (int*) malloc(capacity * sizeof(int));
+    g->parentEdge = (int*) malloc(capacity * sizeof(int));
+
+    g->edgeCapacity = capacity * 2;
+    g->numEdges = 0;
+    g->edges = (Edge*) malloc(g->edgeCapacity * sizeof(Edge));
+    g->edgeNameIds = (int*) malloc(g->edgeCapacity * sizeof(int));
+
+    g->nameCapacity = 256;
+    g->names = (char**) malloc(g->nameCapacity * sizeof(char*));
+    g->nameNext = (int*) malloc(g->nameCapacity * sizeof(int));
+
+    // Alociraj hes mape
+    g->nodeMap = (int*) malloc(HASH_SIZE * sizeof(int));
+    g->nameMap = (int*) malloc(HASH_SIZE * sizeof(int));
+    if (!g->nodeMap || !g->nodes || !g->hashNext || !g->lat || !g->lon || !g->firstEdge ||
+        !g->dist || !g->visited || !g->parent || !g->parentEdge || !g->edges || !g->edgeNameIds ||
+        !g->names || !g->nameNext || !g->nameMap) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za graf (%d cvorova)\n", capacity);
+        freeGraph(g);
         return NULL;
     }
-    
+    for (int i = 0; i < HASH_SIZE; i++) g->nodeMap[i] = -1;
+    for (int i = 0; i < HASH_SIZE; i++) g->nameMap[i] = -1;
+
     return g;
 }
 
 // jednostavna hes funkcija za long long ID-eve
-unsigned int hash(long long id) {
+static unsigned int nodeHash(long long id) {
     if (id < 0) id = -id;
     return (unsigned int)(id % HASH_SIZE);
 }
 
-void addNode(Graph *g, long long id, double lat, double lon, const char *name) {
-    Node *newNode = (Node*) malloc(sizeof(Node));
-    newNode->id = id;
-    newNode->lat = lat;
-    newNode->lon = lon;
-    newNode->name = name ? strdup(name) : NULL;
-    newNode->edges = NULL;
-    
-    // dodaj u povezanu listu svih cvorova (za iteraciju/ciscenje)
-    newNode->nextGlobal = g->nodes;
-    g->nodes = newNode;
-    
-    // Dodaj u hes mapu
-    unsigned int h = hash(id);
-    newNode->next = g->nodeMap[h];
-    g->nodeMap[h] = newNode;
-    
-    g->numNodes++;
+// prosiruje sve nizove cvorova (pokazivaci na Node postaju nevazeci).
+// Kapacitet se mijenja tek kad su svi nizovi prosireni, pa je graf i nakon
+// neuspjeha ispravan (neki nizovi su samo veci nego sto treba).
+static int growNodes(Graph *g) {
+    if (g->capacity > INT_MAX / 2) return -1;
+    int cap = g->capacity * 2;
+    GROW_ARRAY(g->nodes, cap);
+    GROW_ARRAY(g->hashNext, cap);
+    GROW_ARRAY(g->lat, cap);
+    GROW_ARRAY(g->lon, cap);
+    GROW_ARRAY(g->firstEdge, cap);
+    GROW_ARRAY(g->dist, cap);
+    GROW_ARRAY(g->visited, cap);
+    GROW_ARRAY(g->parent, cap);
+    GROW_ARRAY(g->parentEdge, cap);
+    g->capacity = cap;
+    return 0;
 }
 
-Node* findNode(Graph *g, long long id) {
-    unsigned int h = hash(id);
-    Node *curr = g->nodeMap[h];
-    while (curr != NULL) {
-        if (curr->id == id) {
-            return curr;
+int addNode(Graph *g, long long id, double lat, double lon, const char *name) {
+    if (g->numNodes == g->capacity && growNodes(g) != 0) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za cvorove (%d)\n", g->numNodes);
+        return -1;
+    }
+
+    char *nameCopy = NULL, *key = NULL;
+    if (name) {
+        nameCopy = strdup(name);
+        key = createNameKey(name); // normalizuje se jednom, pri ucitavanju
+        if (!nameCopy || !key) {
+            fprintf(stderr, "Greska: nema dovoljno memorije za ime cvora\n");
+            free(nameCopy);
+            free(key);
+            return -1;
         }
-        curr = curr->next;
     }
-    return NULL;
+
+    int idx = g->numNodes++;
+    g->nodes[idx].id = id;
+    g->nodes[idx].name = nameCopy;
+    g->nodes[idx].key = key;
+    g->lat[idx] = (int32_t) lround(lat * COORD_SCALE);
+    g->lon[idx] = (int32_t) lround(lon * COORD_SCALE);
+    g->firstEdge[idx] = -1;
+
+    // Dodaj u hes mapu
+    unsigned int h = nodeHash(id);
+    g->hashNext[idx] = g->nodeMap[h];
+    g->nodeMap[h] = idx;
+    return 0;
 }
 
-// pomocna funkcija za pretragu podstringa neosjetljivu na velicinu slova
-int containsIgnoreCase(const char *haystack, const char *needle) {
-    if (!haystack || !needle) return 0;
-    
-    // Jednostavna implementacija
-    int hLen = strlen(haystack);
-    int nLen = strlen(needle);
-    if (nLen > hLen) return 0;
-    
-    for (int i = 0; i <= hLen - nLen; i++) {
-        int match = 1;
-        for (int j = 0; j < nLen; j++) {
-            char h = haystack[i+j];
-            char n = needle[j];
-            
-            // pretvori u mala slova
-            if (h >= 'A' && h <= 'Z') h += 32;
-            if (n >= 'A' && n <= 'Z') n += 32;
-            
-            if (h != n) {
-                match = 0;
-                break;
-            }
+int findNodeIndex(Graph *g, long long id) {
+    unsigned int h = nodeHash(id);
+    int curr = g->nodeMap[h];
+    while (curr != -1) {
+        if (g->nodes[curr].id == id) {
+            return curr;
         }
-        if (match) return 1;
+        curr = g->hashNext[curr];
     }
-    return 0;
+    return -1;
+}
+
+Node* findNode(Graph *g, long long id) {
+    int idx = findNodeIndex(g, id);
+    return idx == -1 ? NULL : &g->nodes[idx];
 }
 
-// Petragu podstringa neosjetljivu na velicinu slova
+// Petragu podstringa po normalizovanim kljucevima
 Node** findNodesByName(Graph *g, const char *search, int *count) {
     *count = 0;
     if (!search || strlen(search) == 0) return NULL;
+
+    // prazan kljuc (npr. samo interpunkcija ili "ъ") bi se poklopio sa svakim imenom
+    char *key = createNameKey(search);
+    if (!key || key[0] == '\0') {
+        free(key);
+        return NULL;
+    }
     
     // prvi prolaz: prebroj poklapanja
     int matches = 0;
-    Node *curr = g->nodes;
-    while (curr != NULL) {
-        if (curr->name && containsIgnoreCase(curr->name, search)) {
+    for (int i = 0; i < g->numNodes; i++) {
+        if (g->nodes[i].key && strstr(g->nodes[i].key, key)) {
             matches++;
         }
-        curr = curr->nextGlobal;
     }
     
-    if (matches == 0) return NULL;
+    if (matches == 0) {
+        free(key);
+        return NULL;
+    }
     
     Node **result = (Node**) malloc(matches * sizeof(Node*));
     *count = matches;
     
     // Drugi prolaz: popuni rezultat
     int idx = 0;
-    curr = g->nodes;
-    while (curr != NULL) {
-        if (curr->name && containsIgnoreCase(curr->name, search)) {
-            result[idx++] = curr;
+    for (int i = 0; i < g->numNodes; i++) {
+        if (g->nodes[i].key && strstr(g->nodes[i].key, key)) {
+            result[idx++] = &g->nodes[i];
         }
-        curr = curr->nextGlobal;
     }
     
+    free(key);
     return result;
 }
 
@@ -127,22 +181,27 @@ Node** findNodesFuzzy(Graph *g, const char *search, int max_dist, int *count) {
     *count = 0;
     if (!search || strlen(search) == 0) return NULL;
     
+    char *key = createNameKey(search);
+    if (!key || key[0] == '\0') {
+        free(key);
+        return NULL;
+    }
+
     // Privremeni niz za cuvanje pogodaka
     Node **temp_results = (Node**) malloc(1000 * sizeof(Node*));
     int matches = 0;
     
-    Node *curr = g->nodes;
-    while (curr != NULL) {
-        if (curr->name) {
-            int dist = levenshtein_distance(curr->name, search);
+    for (int i = 0; i < g->numNodes; i++) {
+        if (g->nodes[i].key) {
+            int dist = levenshtein_distance(g->nodes[i].key, key);
             if (dist <= max_dist) {
                 if (matches < 1000) {
-                    temp_results[matches++] = curr;
+                    temp_results[matches++] = &g->nodes[i];
                 }
             }
         }
-        curr = curr->nextGlobal;
     }
+    free(key);
     
     if (matches == 0) {
         free(temp_results);
@@ -159,71 +218,257 @@ Node** findNodesFuzzy(Graph *g, const char *search, int max_dist, int *count) {
     return result;
 }
 
+#define NEAREST_CHUNK 256
+
 Node* getNearestNode(Graph *g, double lat, double lon) {
-    Node *nearest = NULL;
-    double minDist = 1e9; // velika pocetna udaljenost
-    
-    Node *curr = g->nodes;
-    while (curr != NULL) {
-        // Samo razmotri cvorove koji imaju ivice (dio su putne mreze)
-        if (curr->edges != NULL) {
-            // jednostavna Euklidska aproksimacija je dovoljna za lokalno pronalazenje najblizeg cvora,
-            // ali mozemo koristiti Haversine ako ukljucimo geometry.h. 
-            // Posto smo u model/graph.c a geometry je u utils, koristimo jednostavni kvadratni Euklid 
-            // na lat/lon radi brzine, jer nam samo treba minimum.
-            // napomena: 1 stepen sirine je ~111km, 1 stepen duzine je ~80km na ovoj sirini.
-            // Mozemo ih tretirati priblizno jednako za nalazenje *najblize* tacke u malom radiusu.
-            
-            double dLat = curr->lat - lat;
-            double dLon = curr->lon - lon;
-            double distSq = dLat*dLat + dLon*dLon;
-            
-            if (distSq < minDist) {
-                minDist = distSq;
-                nearest = curr;
+    int nearest = -1;
+    double minDist = 1e30; // velika pocetna udaljenost
+
+    // kandidati se obradjuju u blokovima da bi se udaljenosti racunale vektorski
+    double qLat[NEAREST_CHUNK], qLon[NEAREST_CHUNK];
+    double cLat[NEAREST_CHUNK], cLon[NEAREST_CHUNK], cDist[NEAREST_CHUNK];
+    int cIdx[NEAREST_CHUNK];
+    for (int k = 0; k < NEAREST_CHUNK; k++) {
+        qLat[k] = lat;
+        qLon[k] = lon;
+    }
+
+    int i = 0;
+    while (i < g->numNodes) {
+        int n = 0;
+        for (; i < g->numNodes && n < NEAREST_CHUNK; i++) {
+            // Samo razmotri cvorove koji imaju ivice (dio su putne mreze)
+            if (g->firstEdge[i] != -1) {
+                cIdx[n] = i;
+                cLat[n] = nodeLat(g, i);
+                cLon[n] = nodeLon(g, i);
+                n++;
+            }
+        }
+        // ekvirektangularna aproksimacija je dovoljno tacna za poredjenje u gradu
+        approximateDistanceBatch(qLat, qLon, cLat, cLon, cDist, n);
+        for (int k = 0; k < n; k++) {
+            if (cDist[k] < minDist) {
+                minDist = cDist[k];
+                nearest = cIdx[k];
             }
         }
-        curr = curr->nextGlobal;
     }
-    return nearest;
+    return nearest == -1 ? NULL : &g->nodes[nearest];
 }
 
-void addEdge(Graph *g, long long srcId, long long destId, double weight, const char *name) {
-    Node *srcNode = findNode(g, srcId);
-    // ne moramo striktno pronaci destNode da bismo dodali ivicu u listu srcNode-a,
-    // ali je dobra praksa osigurati da postoji.
-    // Za ovu implementaciju, pretpostavljamo da su cvorovi dodati prije ivica.
-    
-    if (srcNode == NULL) return;
+// prosiruje niz ivica i imena ivica (kapacitet se mijenja tek kad oba uspiju)
+static int growEdges(Graph *g) {
+    if (g->edgeCapacity > INT_MAX / 2) return -1;
+    int cap = g->edgeCapacity * 2;
+    GROW_ARRAY(g->edges, cap);
+    GROW_ARRAY(g->edgeNameIds, cap);
+    g->edgeCapacity = cap;
+    return 0;
+}
+
+int addEdge(Graph *g, long long srcId, long long destId, double weight, const char *name) {
+    int src = findNodeIndex(g, srcId);
+    int dest = findNodeIndex(g, destId);
+    // ivica cuva indeks ciljnog cvora, pa oba cvora moraju vec postojati
+    if (src == -1 || dest == -1) return 0;
+
+    if (g->numEdges == g->edgeCapacity && growEdges(g) != 0) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za ivice (%d)\n", g->numEdges);
+        return -1;
+    }
+    int nameId = internName(g, name);
+    if (nameId == -1 && name && name[0] != '\0') return -1;
 
-    Edge *newEdge = (Edge*) malloc(sizeof(Edge));
-    newEdge->targetNodeId = destId;
-    newEdge->weight = weight;
-    newEdge->name = strdup(name ? name : "");
-    newEdge->next = srcNode->edges;
-    srcNode->edges = newEdge;
+    int e = g->numEdges++;
+    g->edges[e].target = dest;
+    g->edges[e].weight = ENCODE_WEIGHT(weight);
+    g->edges[e].next = g->firstEdge[src];
+    g->edgeNameIds[e] = nameId;
+    g->firstEdge[src] = e;
+    return 0;
 }
 
-void freeGraph(Graph *g) {
-    // Iteriraj kroz hes mapu da oslobodis cvorove
-    for (int i = 0; i < HASH_SIZE; i++) {
-        Node *curr = g->nodeMap[i];
-        while (curr != NULL) {
-            Node *temp = curr;
-            curr = curr->next;
-            
-            // oslobodi ivice
-            Edge *e = temp->edges;
-            while (e != NULL) {
-                Edge *eTemp = e;
-                e = e->next;
-                free(eTemp->name);
-                free(eTemp);
+// djb2 hes za imena
+static unsigned int hashName(const char *name) {
+    unsigned int h = 5381;
+    for (const unsigned char *p = (const unsigned char*) name; *p; p++) h = h * 33 + *p;
+    return h % HASH_SIZE;
+}
+
+static int growNames(Graph *g) {
+    if (g->nameCapacity > INT_MAX / 2) return -1;
+    int cap = g->nameCapacity * 2;
+    GROW_ARRAY(g->names, cap);
+    GROW_ARRAY(g->nameNext, cap);
+    g->nameCapacity = cap;
+    return 0;
+}
+
+int internName(Graph *g, const char *name) {
+    if (!name || name[0] == '\0') return -1;
+
+    unsigned int h = hashName(name);
+    for (int i = g->nameMap[h]; i != -1; i = g->nameNext[i]) {
+        if (strcmp(g->names[i], name) == 0) return i;
+    }
+
+    if (g->numNames == g->nameCapacity && growNames(g) != 0) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za imena ulica (%d)\n", g->numNames);
+        return -1;
+    }
+    char *copy = strdup(name);
+    if (!copy) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za imena ulica (%d)\n", g->numNames);
+        return -1;
+    }
+    int id = g->numNames++;
+    g->names[id] = copy;
+    g->nameNext[id] = g->nameMap[h];
+    g->nameMap[h] = id;
+    return id;
+}
+
+Graph* createReverseGraph(Graph *g) {
+    Graph *r = createGraph(g->numNodes);
+    if (!r) return NULL;
+
+    // isti redoslijed cvorova, pa su indeksi u oba grafa jednaki
+    for (int i = 0; i < g->numNodes; i++) {
+        if (addNode(r, g->nodes[i].id, nodeLat(g, i), nodeLon(g, i), NULL) != 0) {
+            freeGraph(r);
+            return NULL;
+        }
+    }
+    for (int u = 0; u < g->numNodes; u++) {
+        for (Edge *e = firstEdge(g, u); e != NULL; e = nextEdge(g, e)) {
+            if (addEdge(r, g->nodes[e->target].id, g->nodes[u].id, edgeWeight(e), edgeName(g, e)) != 0) {
+                freeGraph(r);
+                return NULL;
             }
-            if (temp->name) free(temp->name);
-            free(temp);
         }
     }
+    return r;
+}
+
+ReverseAdjacency* createReverseAdjacency(Graph *g) {
+    ReverseAdjacency *r = (ReverseAdjacency*) calloc(1, sizeof(ReverseAdjacency));
+    if (!r) return NULL;
+    int n = g->numNodes, m = g->numEdges;
+    r->numNodes = n;
+    r->numEdges = m;
+    r->firstEdge = (int*) malloc((n + 1) * sizeof(int));
+    r->edges = (Edge*) malloc((m + 1) * sizeof(Edge));
+    r->forwardEdge = (int*) malloc((m + 1) * sizeof(int));
+    r->dist = (double*) malloc((n + 1) * sizeof(double));
+    r->parent = (int*) malloc((n + 1) * sizeof(int));
+    r->parentEdge = (int*) malloc((n + 1) * sizeof(int));
+    r->visited = (unsigned char*) malloc(n + 1);
+    if (!r->firstEdge || !r->edges || !r->forwardEdge || !r->dist || !r->parent || !r->parentEdge || !r->visited) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za obrnute ivice (%d ivica)\n", m);
+        freeReverseAdjacency(r);
+        return NULL;
+    }
+
+    // ulazne ivice cvora su uzastopne u memoriji (kao ivice grafa nakon preslagivanja):
+    // firstEdge[v] je prvo prebrojan pocetak bloka, a zatim pozicija za upis
+    for (int v = 0; v <= n; v++) r->firstEdge[v] = 0;
+    for (int u = 0; u < n; u++) {
+        for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) r->firstEdge[g->edges[k].target + 1]++;
+    }
+    for (int v = 0; v < n; v++) r->firstEdge[v + 1] += r->firstEdge[v];
+    for (int u = 0; u < n; u++) {
+        for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) {
+            int pos = r->firstEdge[g->edges[k].target]++;
+            r->edges[pos].target = u;
+            r->edges[pos].weight = g->edges[k].weight;
+            r->forwardEdge[pos] = k;
+        }
+    }
+    // nakon upisa firstEdge[v] pokazuje na kraj bloka v, tj. pocetak bloka v + 1
+    for (int v = n; v > 0; v--) r->firstEdge[v] = r->firstEdge[v - 1];
+    r->firstEdge[0] = 0;
+    for (int v = 0; v < n; v++) {
+        int end = r->firstEdge[v + 1];
+        for (int k = r->firstEdge[v]; k < end; k++) r->edges[k].next = k + 1 < end ? k + 1 : -1;
+        if (r->firstEdge[v] == end) r->firstEdge[v] = -1;
+    }
+    return r;
+}
+
+void freeReverseAdjacency(ReverseAdjacency *r) {
+    if (!r) return;
+    free(r->firstEdge);
+    free(r->edges);
+    free(r->forwardEdge);
+    free(r->dist);
+    free(r->parent);
+    free(r->parentEdge);
+    free(r->visited);
+    free(r);
+}
+
+// FNV-1a korak nad 64-bitnom vrijednoscu, uz mijesanje visih bitova nanize
+static uint64_t mixChecksum(uint64_t h, uint64_t v) {
+    h ^= v;
+    h *= 1099511628211ULL;
+    return h ^ (h >> 29);
+}
+
+void rebuildNodeMap(Graph *g) {
+    for (int h = 0; h < HASH_SIZE; h++) g->nodeMap[h] = -1;
+    for (int i = g->numNodes - 1; i >= 0; i--) {
+        unsigned int h = nodeHash(g->nodes[i].id);
+        g->hashNext[i] = g->nodeMap[h];
+        g->nodeMap[h] = i;
+    }
+}
+
+uint64_t graphChecksum(Graph *g) {
+    uint64_t h = 1469598103934665603ULL;
+    h = mixChecksum(h, EDGE_WEIGHT_MODE);
+    h = mixChecksum(h, sizeof(EdgeWeight));
+    h = mixChecksum(h, (uint64_t) g->numNodes);
+    h = mixChecksum(h, (uint64_t) g->numEdges);
+    for (int i = 0; i < g->numNodes; i++) {
+        h = mixChecksum(h, (uint64_t) g->nodes[i].id);
+        for (int k = g->firstEdge[i]; k != -1; k = g->edges[k].next) {
+            uint64_t w = 0;
+            memcpy(&w, &g->edges[k].weight, sizeof(EdgeWeight));
+            h = mixChecksum(h, (uint64_t) g->edges[k].target);
+            h = mixChecksum(h, w);
+        }
+    }
+    return h;
+}
+
+void freeGraph(Graph *g) {
+    if (!g) return;
+    if (g->nodes) {
+        for (int i = 0; i < g->numNodes; i++) {
+            if (g->nodes[i].name) free(g->nodes[i].name);
+            free(g->nodes[i].key);
+        }
+    }
+    if (g->names) {
+        for (int i = 0; i < g->numNames; i++) {
+            free(g->names[i]);
+        }
+    }
+    free(g->nodes);
+    free(g->hashNext);
+    free(g->lat);
+    free(g->lon);
+    free(g->firstEdge);
+    free(g->dist);
+    free(g->visited);
+    free(g->parent);
+    free(g->parentEdge);
+    free(g->edges);
+    free(g->edgeNameIds);
+    free(g->names);
+    free(g->nameNext);
+    free(g->nameMap);
     free(g->nodeMap);
     free(g);
 }
@@ -2,47 +2,106 @@
 #define GRAPH_H
 
 #include <stdlib.h>
+#include <stdint.h>
 
-// Struktura cvora koja predstavlja lokaciju na mapi
+// Koordinate se cuvaju kao int32 u fiksnom zarezu (1e-7 stepena),
+// sto daje preciznost od ~1cm i upola manje memorije od double.
+#define COORD_SCALE 10000000.0
+
+// Tip tezine ivice. Podrazumijevano double, a moze se smanjiti
+// kompajliranjem sa -DEDGE_WEIGHT_FLOAT (float) ili -DEDGE_WEIGHT_CM
+// (cijeli centimetri) da bi ivica zauzimala 12 umjesto 16 bajtova.
+#if defined(EDGE_WEIGHT_CM)
+typedef int32_t EdgeWeight;
+#define EDGE_WEIGHT_MODE 2
+#define ENCODE_WEIGHT(m) ((EdgeWeight) ((m) * 100.0 + 0.5))
+#define DECODE_WEIGHT(w) ((w) / 100.0)
+#elif defined(EDGE_WEIGHT_FLOAT)
+typedef float EdgeWeight;
+#define EDGE_WEIGHT_MODE 1
+#define ENCODE_WEIGHT(m) ((EdgeWeight) (m))
+#define DECODE_WEIGHT(w) ((double) (w))
+#else
+typedef double EdgeWeight;
+#define EDGE_WEIGHT_MODE 0
+#define ENCODE_WEIGHT(m) (m)
+#define DECODE_WEIGHT(w) (w)
+#endif
+
+// Hladni podaci o cvoru (ID i ime) - ne koriste se tokom pretrage.
+// Cvor se identifikuje svojim indeksom u g->nodes.
 typedef struct Node {
     long long id;
-    double lat;
-    double lon;
     char *name; // ime lokacije
-    struct Edge *edges; // glava liste ivica
-    struct Node *next;  // za hes mapu
-    struct Node *nextGlobal; // Za listu svih cvorova
-    
-    // Za Dijkstru
-    double dist;
-    int visited;
-    struct Node *parent;
+    char *key;  // normalizovano ime za pretragu (vidi utils/normalize.h)
 } Node;
 
 // struktura ivice koja predstavlja segment ulice
+// Ivice su u zajednickom nizu g->edges, povezane indeksima (next).
 typedef struct Edge {
-    long long targetNodeId;
-    double weight; // Udaljenost u metrima
-    char *name;    // Ime ulice
-    struct Edge *next;
+    int target;        // indeks ciljnog cvora
+    int next;          // indeks sljedece ivice istog cvora, -1 za kraj
+    EdgeWeight weight; // Udaljenost u metrima
 } Edge;
 
-// struktura grafa
+// struktura grafa (niz struktura po poljima, "structure of arrays")
 typedef struct Graph {
     int numNodes;
-    Node **nodeMap; // Hes mapa
     int capacity;
-    Node *nodes; // Povezana lista svih cvorova za iteraciju
+    Node *nodes;     // hladni podaci, indeksirani indeksom cvora
+    int *nodeMap;    // Hes mapa: glava lanca (indeks cvora ili -1)
+    int *hashNext;   // sljedeci cvor u lancu hes mape
+
+    // Vruci podaci za pretragu
+    int32_t *lat;    // sirina * 1e7
+    int32_t *lon;    // duzina * 1e7
+    int *firstEdge;  // glava liste ivica (indeks u edges ili -1)
+
+    // Stanje Dijkstre
+    double *dist;
+    unsigned char *visited;
+    int *parent;     // indeks roditelja ili -1
+    int *parentEdge; // indeks ivice parent -> cvor ili -1
+
+    // Ivice
+    Edge *edges;
+    int *edgeNameIds; // Ime ulice za svaku ivicu: indeks u names ili -1 (hladno)
+    int numEdges;
+    int edgeCapacity;
+
+    // Imena ulica, svako sacuvano jednom
+    char **names;
+    int numNames;
+    int nameCapacity;
+    int *nameMap;     // Hes mapa imena: glava lanca (indeks imena ili -1)
+    int *nameNext;    // sljedece ime u lancu
 } Graph;
 
+// Redoslijed cvorova u memoriji (vidi reorderGraph)
+typedef enum NodeOrder {
+    ORDER_NONE,    // redoslijed iz fajla
+    ORDER_HILBERT, // po Hilbertovoj krivoj preko lat/lon (susjedni cvorovi blizu u memoriji)
+    ORDER_BFS      // pretraga u sirinu kroz putnu mrezu
+} NodeOrder;
+
 Graph* createGraph(int capacity);
 
-void addNode(Graph *g, long long id, double lat, double lon, const char *name);
+// Vraca 0 ili -1 ako nema dovoljno memorije (graf tada ostaje ispravan, bez novog cvora)
+int addNode(Graph *g, long long id, double lat, double lon, const char *name);
+
+// Ivica ka cvoru koji ne postoji se preskace (vraca 0); -1 samo ako nema dovoljno memorije
+int addEdge(Graph *g, long long srcId, long long destId, double weight, const char *name);
+
+// Indeks imena ulice u g->names (dodaje ga ako ne postoji); -1 za NULL ili prazno ime
+// i kad nema dovoljno memorije za novo ime
+int internName(Graph *g, const char *name);
 
-void addEdge(Graph *g, long long srcId, long long destId, double weight, const char *name);
+Node* findNode(Graph *g, long long id);
 
-Node* findNode(Graph *g, long long id); 
+// Vraca indeks cvora sa datim ID-em ili -1
+int findNodeIndex(Graph *g, long long id);
 
+// Pretraga podstringa po normalizovanim kljucevima (velicina slova, dijakritici i pismo se ne razlikuju)
 Node** findNodesByName(Graph *g, const char *search, int *count);
 
 // Pronalazi cvorove cije je ime slicno trazenom (Levenstajnova udaljenost)
@@ -50,8 +109,61 @@ Node** findNodesFuzzy(Graph *g, const char *search, int max_dist, int *count);
 
 Node* getNearestNode(Graph *g, double lat, double lon);
 
-Node* getNearestNode(Graph *g, double lat, double lon);
+// Prenumerise cvorove po datom redoslijedu i preslaze sve nizove cvorova i ivica,
+// tako da su ivice jednog cvora uzastopne u memoriji. Indeksi cvorova se mijenjaju
+// (ID-evi ostaju isti), pa se poziva odmah nakon ucitavanja.
+void reorderGraph(Graph *g, NodeOrder mode);
+
+// Gradi hes mapu ID -> indeks iznova (nakon sto se cvorovi prenumerisu)
+void rebuildNodeMap(Graph *g);
+
+// "none", "hilbert" ili "bfs"
+NodeOrder parseNodeOrder(const char *name);
+
+// Kontrolni zbir grafa: ID-evi cvorova u redoslijedu indeksa, sve ivice (cilj i
+// tezina) i tip tezine; prepoznaje da li sacuvane tabele (orijentiri, overlay)
+// pripadaju ucitanom grafu i ovom buildu
+uint64_t graphChecksum(Graph *g);
+
+// Graf sa obrnutim smjerom svih ivica (indeksi cvorova ostaju isti)
+Graph* createReverseGraph(Graph *g);
 
 void freeGraph(Graph *g);
 
+// Samo obrnute ivice grafa (za svaku ivicu u -> v ivica v -> u, isti indeksi cvorova),
+// bez cvorova, hes mape i imena, uz prostor za pretragu unazad
+typedef struct ReverseAdjacency {
+    int numNodes;
+    int numEdges;
+    int *firstEdge;
+    Edge *edges;            // target = pocetak originalne ivice, ista tezina
+    int *forwardEdge;       // indeks originalne ivice u g->edges
+    double *dist;           // pretraga unazad (kao g->dist, g->parent, g->parentEdge, g->visited)
+    int *parent;
+    int *parentEdge;
+    unsigned char *visited;
+} ReverseAdjacency;
+
+ReverseAdjacency* createReverseAdjacency(Graph *g);
+void freeReverseAdjacency(ReverseAdjacency *r);
+
+// Pristupne funkcije
+static inline int nodeIndex(Graph *g, Node *n) { return (int) (n - g->nodes); }
+static inline double nodeLat(Graph *g, int idx) { return g->lat[idx] / COORD_SCALE; }
+static inline double nodeLon(Graph *g, int idx) { return g->lon[idx] / COORD_SCALE; }
+static inline int nodeHasEdges(Graph *g, int idx) { return g->firstEdge[idx] != -1; }
+
+static inline Edge* firstEdge(Graph *g, int idx) {
+    return g->firstEdge[idx] == -1 ? NULL : &g->edges[g->firstEdge[idx]];
+}
+static inline Edge* nextEdge(Graph *g, Edge *e) {
+    return e->next == -1 ? NULL : &g->edges[e->next];
+}
+static inline double edgeWeight(Edge *e) { return DECODE_WEIGHT(e->weight); }
+static inline int edgeNameId(Graph *g, Edge *e) { return g->edgeNameIds[e - g->edges]; }
+static inline const char* edgeName(Graph *g, Edge *e) {
+    int id = edgeNameId(g, e);
+    return id == -1 ? NULL : g->names[id];
+}
+
 #endif
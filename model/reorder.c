@@ -0,0 +1,172 @@
+#include "graph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    uint32_t key;
+    int node;
+} OrderKey;
+
+static int compareKeys(const void *a, const void *b) {
+    const OrderKey *x = (const OrderKey*) a;
+    const OrderKey *y = (const OrderKey*) b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->node - y->node;
+}
+
+// indeks tacke (x, y) na Hilbertovoj krivoj u mrezi 65536 x 65536
+static uint32_t hilbertIndex(uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // rotiraj kvadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            uint32_t t = x;
+            x = y;
+            y = t;
+        }
+    }
+    return d;
+}
+
+// order[i] = stari indeks cvora koji postaje i-ti
+static int hilbertOrder(Graph *g, int *order) {
+    int32_t minLat = INT32_MAX, maxLat = INT32_MIN, minLon = INT32_MAX, maxLon = INT32_MIN;
+    for (int i = 0; i < g->numNodes; i++) {
+        if (g->lat[i] < minLat) minLat = g->lat[i];
+        if (g->lat[i] > maxLat) maxLat = g->lat[i];
+        if (g->lon[i] < minLon) minLon = g->lon[i];
+        if (g->lon[i] > maxLon) maxLon = g->lon[i];
+    }
+    double scaleLat = maxLat > minLat ? 65535.0 / ((double) maxLat - minLat) : 0;
+    double scaleLon = maxLon > minLon ? 65535.0 / ((double) maxLon - minLon) : 0;
+
+    OrderKey *keys = (OrderKey*) malloc(g->numNodes * sizeof(OrderKey));
+    if (!keys) return -1;
+    for (int i = 0; i < g->numNodes; i++) {
+        uint32_t x = (uint32_t) (((double) g->lon[i] - minLon) * scaleLon);
+        uint32_t y = (uint32_t) (((double) g->lat[i] - minLat) * scaleLat);
+        keys[i].key = hilbertIndex(x, y);
+        keys[i].node = i;
+    }
+    qsort(keys, g->numNodes, sizeof(OrderKey), compareKeys);
+    for (int i = 0; i < g->numNodes; i++) order[i] = keys[i].node;
+    free(keys);
+    return 0;
+}
+
+// BFS redoslijed; nove komponente pocinju od cvorova redom po Hilbertovoj krivoj
+static int bfsOrder(Graph *g, int *order) {
+    int *seeds = (int*) malloc(g->numNodes * sizeof(int));
+    unsigned char *seen = (unsigned char*) calloc(g->numNodes, 1);
+    if (!seeds || !seen || hilbertOrder(g, seeds) != 0) {
+        free(seen);
+        free(seeds);
+        return -1;
+    }
+
+    int head = 0, tail = 0;
+    for (int s = 0; s < g->numNodes; s++) {
+        if (seen[seeds[s]]) continue;
+        seen[seeds[s]] = 1;
+        order[tail++] = seeds[s];
+        while (head < tail) {
+            int u = order[head++];
+            for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) {
+                int v = g->edges[k].target;
+                if (!seen[v]) {
+                    seen[v] = 1;
+                    order[tail++] = v;
+                }
+            }
+        }
+    }
+    free(seen);
+    free(seeds);
+    return 0;
+}
+
+void reorderGraph(Graph *g, NodeOrder mode) {
+    int n = g->numNodes;
+    if (mode == ORDER_NONE || n == 0) return;
+
+    // sve se alocira unaprijed: bez memorije graf ostaje u starom redoslijedu
+    int *order = (int*) malloc(n * sizeof(int));
+    int *newIndex = (int*) malloc(n * sizeof(int));
+    Edge *edges = (Edge*) malloc(g->edgeCapacity * sizeof(Edge));
+    int *edgeNameIds = (int*) malloc(g->edgeCapacity * sizeof(int));
+    int *firstEdge = (int*) malloc(g->capacity * sizeof(int));
+    Node *nodes = (Node*) malloc(g->capacity * sizeof(Node));
+    int32_t *lat = (int32_t*) malloc(g->capacity * sizeof(int32_t));
+    int32_t *lon = (int32_t*) malloc(g->capacity * sizeof(int32_t));
+    int ok = order && newIndex && edges && edgeNameIds && firstEdge && nodes && lat && lon;
+    if (ok) ok = (mode == ORDER_HILBERT ? hilbertOrder(g, order) : bfsOrder(g, order)) == 0;
+    if (!ok) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za preslagivanje cvorova, redoslijed ostaje isti\n");
+        free(order);
+        free(newIndex);
+        free(edges);
+        free(edgeNameIds);
+        free(firstEdge);
+        free(nodes);
+        free(lat);
+        free(lon);
+        return;
+    }
+
+    for (int i = 0; i < n; i++) newIndex[order[i]] = i;
+
+    // ivice: svaki cvor dobija uzastopan blok ivica, istim redoslijedom kao prije
+    int e = 0;
+    for (int i = 0; i < n; i++) {
+        int old = order[i];
+        firstEdge[i] = g->firstEdge[old] == -1 ? -1 : e;
+        for (int k = g->firstEdge[old]; k != -1; k = g->edges[k].next) {
+            edges[e] = g->edges[k];
+            edges[e].target = newIndex[g->edges[k].target];
+            edges[e].next = g->edges[k].next == -1 ? -1 : e + 1;
+            edgeNameIds[e] = g->edgeNameIds[k];
+            e++;
+        }
+    }
+    free(g->edges);
+    free(g->edgeNameIds);
+    free(g->firstEdge);
+    g->edges = edges;
+    g->edgeNameIds = edgeNameIds;
+    g->firstEdge = firstEdge;
+
+    // cvorovi (nizovi zadrzavaju kapacitet zbog kasnijeg addNode)
+    for (int i = 0; i < n; i++) {
+        nodes[i] = g->nodes[order[i]];
+        lat[i] = g->lat[order[i]];
+        lon[i] = g->lon[order[i]];
+    }
+    free(g->nodes);
+    free(g->lat);
+    free(g->lon);
+    g->nodes = nodes;
+    g->lat = lat;
+    g->lon = lon;
+
+    rebuildNodeMap(g);
+
+    free(newIndex);
+    free(order);
+}
+
+NodeOrder parseNodeOrder(const char *name) {
+    if (strcmp(name, "hilbert") == 0) return ORDER_HILBERT;
+    if (strcmp(name, "bfs") == 0) return ORDER_BFS;
+    if (strcmp(name, "none") != 0) {
+        fprintf(stderr, "Nepoznat redoslijed \"%s\", koristi se none\n", name);
+    }
+    return ORDER_NONE;
+}
@@ -0,0 +1,204 @@
+#include "alternatives.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+
+// plato kao kandidat za alternativu
+typedef struct {
+    int start;      // prvi cvor platoa (najblizi startu)
+    double length;  // duzina rute start -> plato -> cilj
+    double plateau; // duzina platoa
+} Candidate;
+
+// kraca ruta sa duzim platoom ide prva
+static int compareCandidates(const void *a, const void *b) {
+    const Candidate *x = (const Candidate*) a;
+    const Candidate *y = (const Candidate*) b;
+    double kx = x->length - x->plateau;
+    double ky = y->length - y->plateau;
+    if (kx != ky) return kx < ky ? -1 : 1;
+    return x->start - y->start;
+}
+
+void defaultAlternativeOptions(AlternativeOptions *opt) {
+    opt->maxRoutes = ALTERNATIVES_DEFAULT_ROUTES;
+    opt->maxStretch = ALTERNATIVES_DEFAULT_STRETCH;
+    opt->maxSharing = ALTERNATIVES_DEFAULT_SHARING;
+    opt->minPlateau = ALTERNATIVES_DEFAULT_PLATEAU;
+}
+
+static void initRoute(PathResult *r) {
+    r->distance = -1;
+    r->pathNodes = NULL;
+    r->pathEdges = NULL;
+    r->pathLength = 0;
+    r->settledNodes = 0;
+    r->status = PATH_NOT_FOUND;
+    r->estimate = FALLBACK_NONE;
+}
+
+// ruta od starta do via po stablu od starta, pa od via do cilja po stablu do cilja;
+// 0 ako ruta prolazi dvaput kroz isti cvor (seen/stamp oznacavaju posjecene cvorove)
+static int buildRoute(Graph *g, ReverseAdjacency *reverse, int via, int *seen, int stamp, PathResult *r) {
+    int forward = 0, backward = 0;
+    for (int v = via; v != -1; v = g->parent[v]) {
+        if (seen[v] == stamp) return 0;
+        seen[v] = stamp;
+        forward++;
+    }
+    for (int v = reverse->parent[via]; v != -1; v = reverse->parent[v]) {
+        if (seen[v] == stamp) return 0;
+        seen[v] = stamp;
+        backward++;
+    }
+
+    r->pathLength = forward + backward;
+    r->pathNodes = (long long*) malloc(r->pathLength * sizeof(long long));
+    r->pathEdges = (int*) malloc(r->pathLength * sizeof(int));
+
+    int i = forward - 1;
+    for (int v = via; v != -1; v = g->parent[v], i--) {
+        r->pathNodes[i] = g->nodes[v].id;
+        r->pathEdges[i] = g->parentEdge[v];
+    }
+    i = forward;
+    for (int x = via, y = reverse->parent[via]; y != -1; x = y, y = reverse->parent[y], i++) {
+        r->pathNodes[i] = g->nodes[y].id;
+        r->pathEdges[i] = reverse->forwardEdge[reverse->parentEdge[x]];
+    }
+    return 1;
+}
+
+// duzina dijela rute koji prolazi vec oznacenim ivicama
+static double sharedLength(Graph *g, const PathResult *r, const unsigned char *used) {
+    double shared = 0;
+    for (int i = 1; i < r->pathLength; i++) {
+        int e = r->pathEdges[i];
+        if (e != -1 && used[e]) shared += edgeWeight(&g->edges[e]);
+    }
+    return shared;
+}
+
+static void markEdges(const PathResult *r, unsigned char *used) {
+    for (int i = 1; i < r->pathLength; i++) {
+        if (r->pathEdges[i] != -1) used[r->pathEdges[i]] = 1;
+    }
+}
+
+int findAlternativeRoutes(Graph *g, ReverseAdjacency *reverse, long long startNodeId, long long endNodeId,
+                          const AlternativeOptions *opt, const SearchLimits *limits, PathResult *routes) {
+    AlternativeOptions o;
+    if (opt) o = *opt;
+    else defaultAlternativeOptions(&o);
+    if (o.maxRoutes < 1) o.maxRoutes = 1;
+    if (o.maxStretch < 1) o.maxStretch = 1;
+
+    for (int i = 0; i < o.maxRoutes; i++) initRoute(&routes[i]);
+
+    int startNode = findNodeIndex(g, startNodeId);
+    int endNode = findNodeIndex(g, endNodeId);
+
+    if (startNode == -1 || endNode == -1) {
+        printf("Start or end node not found.\n");
+        return 0;
+    }
+
+    // jedna dvosmjerna pretraga, obje strane do granice stretch * d;
+    // strana od cilja daje udaljenosti do cilja
+    PathStatus status = PATH_OK;
+    int meet;
+    int settled = computeBidirectionalTrees(g, reverse, startNode, endNode, o.maxStretch, limits, &status, &meet);
+    routes[0].settledNodes = settled;
+
+    int *seen = (int*) calloc(g->numNodes, sizeof(int));
+    int stamp = 1;
+
+    // prekid: bez alternativa; najkraci put kroz cvor spajanja ako je d vec odredjeno,
+    // inace procjena po limits->fallback
+    if (status != PATH_OK) {
+        routes[0].status = status;
+        int found = 0;
+        if (meet != -1 && buildRoute(g, reverse, meet, seen, stamp, &routes[0])) {
+            routes[0].distance = g->dist[meet] + reverse->dist[meet];
+            found = 1;
+        }
+        else {
+            applyFallback(g, startNode, endNode, limits->fallback, &routes[0]);
+            found = routes[0].estimate != FALLBACK_NONE;
+        }
+        free(seen);
+        return found;
+    }
+
+    double d = g->dist[endNode];
+    if (d == DBL_MAX) {
+        free(seen);
+        return 0;
+    }
+
+    unsigned char *used = (unsigned char*) calloc(g->numEdges > 0 ? g->numEdges : 1, 1);
+
+    // najkraci put: cijeli po stablu od starta
+    buildRoute(g, reverse, endNode, seen, stamp, &routes[0]);
+    routes[0].distance = d;
+    routes[0].status = PATH_OK;
+    markEdges(&routes[0], used);
+    int found = 1;
+
+    // platoi: lanci ivica x -> y sa g->parent[y] == x i reverse->parent[x] == y
+    Candidate *candidates = NULL;
+    int numCandidates = 0, capacity = 0;
+    double *df = g->dist, *db = reverse->dist;
+    int *fp = g->parent, *bp = reverse->parent;
+    double bound = d * o.maxStretch;
+    for (int v = 0; v < g->numNodes && o.maxRoutes > 1 && d > 0; v++) {
+        if (df[v] == DBL_MAX || db[v] == DBL_MAX || df[v] + db[v] > bound) continue;
+        if (fp[v] != -1 && bp[fp[v]] == v) continue; // nije pocetak platoa
+
+        int w = v;
+        while (bp[w] != -1 && fp[bp[w]] == w) w = bp[w];
+        double plateau = df[w] - df[v];
+        if (plateau < o.minPlateau * d) continue;
+
+        if (numCandidates == capacity) {
+            capacity = capacity ? 2 * capacity : 64;
+            candidates = (Candidate*) realloc(candidates, capacity * sizeof(Candidate));
+        }
+        Candidate *c = &candidates[numCandidates++];
+        c->start = v;
+        c->length = df[v] + db[v];
+        c->plateau = plateau;
+    }
+    if (numCandidates > 1) qsort(candidates, numCandidates, sizeof(Candidate), compareCandidates);
+
+    for (int i = 0; i < numCandidates && found < o.maxRoutes; i++) {
+        PathResult r;
+        initRoute(&r);
+        if (!buildRoute(g, reverse, candidates[i].start, seen, ++stamp, &r)) continue;
+        if (sharedLength(g, &r, used) > o.maxSharing * d) {
+            freePathResult(r);
+            continue;
+        }
+        markEdges(&r, used);
+        r.distance = candidates[i].length;
+        r.status = PATH_OK;
+        r.settledNodes = settled;
+        routes[found++] = r;
+    }
+
+    // alternative po duzini (najkraci put ostaje prvi)
+    for (int i = 2; i < found; i++) {
+        PathResult r = routes[i];
+        int j = i;
+        while (j > 1 && routes[j - 1].distance > r.distance) {
+            routes[j] = routes[j - 1];
+            j--;
+        }
+        routes[j] = r;
+    }
+
+    free(candidates);
+    free(used);
+    free(seen);
+    return found;
+}
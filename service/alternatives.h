@@ -0,0 +1,38 @@
+#ifndef ALTERNATIVES_H
+#define ALTERNATIVES_H
+
+#include "../model/graph.h"
+#include "pathfinder.h"
+
+// Alternativne rute iz jedne dvosmjerne pretrage (metod platoa): stablo najkracih puteva
+// od starta na grafu i stablo do cilja po obrnutim ivicama, oba do granice stretch * d.
+// Plato je lanac ivica koji je u oba stabla; ruta start -> plato -> cilj je lokalno
+// optimalna na svakom dijelu kracem od platoa, pa nisu potrebne dodatne pretrage.
+
+#define ALTERNATIVES_DEFAULT_ROUTES 3
+#define ALTERNATIVES_DEFAULT_STRETCH 1.25 // najvise 25% duze od najkraceg puta
+#define ALTERNATIVES_DEFAULT_SHARING 0.8  // najvise 80% duzine najkraceg puta zajednicko sa ranijim rutama
+#define ALTERNATIVES_DEFAULT_PLATEAU 0.25 // plato najmanje 25% duzine najkraceg puta
+
+typedef struct AlternativeOptions {
+    int maxRoutes;      // najvise ruta, ukljucujuci najkracu
+    double maxStretch;  // duzina rute <= maxStretch * d
+    double maxSharing;  // zajednicki dio sa vec izabranim rutama <= maxSharing * d
+    double minPlateau;  // lokalna optimalnost: plato >= minPlateau * d
+} AlternativeOptions;
+
+// Popunjava podrazumijevane vrijednosti
+void defaultAlternativeOptions(AlternativeOptions *opt);
+
+// Najkraci put i do opt->maxRoutes - 1 alternativa, po rastucoj duzini; routes mora
+// imati mjesta za opt->maxRoutes rezultata, a oslobadjaju se sa freePathResult.
+// reverse = createReverseAdjacency(g), pravi se jednom za sve upite; opt i limits mogu biti NULL
+// (limits->maxSettled vazi za obje strane pretrage zajedno).
+// Vraca broj ruta; ako je 0, routes[0].status daje razlog (nema puta ili prekid).
+// Nakon prekida (routes[0].status = PATH_TIMEOUT ili PATH_CANCELLED) alternativa nema:
+// ako je d vec odredjeno, vraca se tacan najkraci put (kroz cvor spajanja), a inace
+// procjena po limits->fallback (kao findShortestPathLimited; 0 ruta za FALLBACK_NONE).
+int findAlternativeRoutes(Graph *g, ReverseAdjacency *reverse, long long startNodeId, long long endNodeId,
+                          const AlternativeOptions *opt, const SearchLimits *limits, PathResult *routes);
+
+#endif
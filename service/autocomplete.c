@@ -0,0 +1,275 @@
+#include "autocomplete.h"
+#include "../utils/normalize.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NAME_SEPARATOR " / "
+#define NAME_BLOCK_SIZE COMPLETE_MAX_RESULTS // list stabla cuva cijeli blok
+
+typedef struct {
+    const char *key;
+    const char *name;
+    int node;
+} NameItem;
+
+static int compareItems(const void *a, const void *b) {
+    const NameItem *x = (const NameItem*) a;
+    const NameItem *y = (const NameItem*) b;
+    int c = strcmp(x->key, y->key);
+    if (c != 0) return c;
+    return x->node - y->node;
+}
+
+// unos za rangiranje: vise cvorova, pa kraci kljuc, pa redoslijed kljuceva
+typedef struct {
+    int nodeCount;
+    int keyLen;
+    int entry;
+} RankItem;
+
+static int compareRank(const void *a, const void *b) {
+    const RankItem *x = (const RankItem*) a;
+    const RankItem *y = (const RankItem*) b;
+    if (x->nodeCount != y->nodeCount) return y->nodeCount - x->nodeCount;
+    if (x->keyLen != y->keyLen) return x->keyLen - y->keyLen;
+    return x->entry - y->entry;
+}
+
+// spaja dvije liste sortirane po rangu u najboljih COMPLETE_MAX_RESULTS (-1 popunjava kraj)
+static void mergeTop(const int *rank, const int *a, const int *b, int *out) {
+    int i = 0, j = 0;
+    for (int n = 0; n < COMPLETE_MAX_RESULTS; n++) {
+        if (i < COMPLETE_MAX_RESULTS && a[i] != -1 &&
+            (j == COMPLETE_MAX_RESULTS || b[j] == -1 || rank[a[i]] < rank[b[j]])) {
+            out[n] = a[i++];
+        }
+        else if (j < COMPLETE_MAX_RESULTS && b[j] != -1) out[n] = b[j++];
+        else out[n] = -1;
+    }
+}
+
+// rang svakog unosa i stablo blokova: list je blok od NAME_BLOCK_SIZE uzastopnih
+// unosa sortiran po rangu, a unutrasnji cvor najboljih COMPLETE_MAX_RESULTS iz djece
+static void buildRankTree(NameIndex *idx) {
+    int n = idx->numEntries;
+    RankItem *items = (RankItem*) malloc((n + 1) * sizeof(RankItem));
+    for (int i = 0; i < n; i++) {
+        items[i].nodeCount = idx->entries[i].nodeCount;
+        items[i].keyLen = (int) strlen(idx->entries[i].key);
+        items[i].entry = i;
+    }
+    qsort(items, n, sizeof(RankItem), compareRank);
+    idx->rank = (int*) malloc((n + 1) * sizeof(int));
+    for (int i = 0; i < n; i++) idx->rank[items[i].entry] = i;
+    free(items);
+
+    int numBlocks = (n + NAME_BLOCK_SIZE - 1) / NAME_BLOCK_SIZE;
+    idx->numLeaves = 1;
+    while (idx->numLeaves < numBlocks) idx->numLeaves *= 2;
+
+    size_t size = 2 * (size_t) idx->numLeaves * COMPLETE_MAX_RESULTS;
+    idx->blockTop = (int*) malloc(size * sizeof(int));
+    for (size_t i = 0; i < size; i++) idx->blockTop[i] = -1;
+
+    for (int b = 0; b < numBlocks; b++) {
+        int *leaf = idx->blockTop + (size_t) (idx->numLeaves + b) * COMPLETE_MAX_RESULTS;
+        int count = 0;
+        for (int i = b * NAME_BLOCK_SIZE; i < n && i < (b + 1) * NAME_BLOCK_SIZE; i++) {
+            int pos = count++;
+            while (pos > 0 && idx->rank[i] < idx->rank[leaf[pos - 1]]) {
+                leaf[pos] = leaf[pos - 1];
+                pos--;
+            }
+            leaf[pos] = i;
+        }
+    }
+    for (int v = idx->numLeaves - 1; v >= 1; v--) {
+        mergeTop(idx->rank,
+                 idx->blockTop + (size_t) (2 * v) * COMPLETE_MAX_RESULTS,
+                 idx->blockTop + (size_t) (2 * v + 1) * COMPLETE_MAX_RESULTS,
+                 idx->blockTop + (size_t) v * COMPLETE_MAX_RESULTS);
+    }
+}
+
+NameIndex* buildNameIndex(Graph *g) {
+    // prvi prolaz: velicina teksta i broj varijanti imena
+    size_t textSize = 0;
+    int numItems = 0;
+    for (int i = 0; i < g->numNodes; i++) {
+        const char *name = g->nodes[i].name;
+        if (!name) continue;
+        textSize += 2 * (strlen(name) + 1);
+        numItems++;
+        for (const char *p = strstr(name, NAME_SEPARATOR); p; p = strstr(p + 1, NAME_SEPARATOR)) {
+            textSize += 2;
+            numItems++;
+        }
+    }
+
+    NameIndex *idx = (NameIndex*) calloc(1, sizeof(NameIndex));
+    idx->arena = (char*) malloc(textSize + 1);
+    NameItem *items = (NameItem*) malloc((numItems + 1) * sizeof(NameItem));
+
+    // drugi prolaz: svaka varijanta postaje (kljuc, ime, cvor)
+    size_t used = 0;
+    int n = 0;
+    for (int i = 0; i < g->numNodes; i++) {
+        const char *name = g->nodes[i].name;
+        if (!name) continue;
+
+        const char *start = name;
+        while (1) {
+            const char *sep = strstr(start, NAME_SEPARATOR);
+            size_t len = sep ? (size_t) (sep - start) : strlen(start);
+            if (len > 0) {
+                char *display = idx->arena + used;
+                memcpy(display, start, len);
+                display[len] = '\0';
+                used += len + 1;
+
+                char *key = idx->arena + used;
+                used += normalizeName(start, len, key) + 1;
+
+                items[n].key = key;
+                items[n].name = display;
+                items[n].node = i;
+                n++;
+            }
+            if (!sep) break;
+            start = sep + strlen(NAME_SEPARATOR);
+        }
+    }
+
+    qsort(items, n, sizeof(NameItem), compareItems);
+
+    // spoji iste kljuceve; isti cvor se za jedan kljuc pamti samo jednom
+    idx->entries = (NameEntry*) malloc((n + 1) * sizeof(NameEntry));
+    idx->nodes = (int*) malloc((n + 1) * sizeof(int));
+    int numNodes = 0;
+    for (int i = 0; i < n; i++) {
+        if (idx->numEntries == 0 || strcmp(idx->entries[idx->numEntries - 1].key, items[i].key) != 0) {
+            NameEntry *e = &idx->entries[idx->numEntries++];
+            e->key = items[i].key;
+            e->name = items[i].name;
+            e->firstNode = numNodes;
+            e->nodeCount = 0;
+        }
+        NameEntry *e = &idx->entries[idx->numEntries - 1];
+        if (e->nodeCount == 0 || idx->nodes[numNodes - 1] != items[i].node) {
+            idx->nodes[numNodes++] = items[i].node;
+            e->nodeCount++;
+        }
+    }
+
+    free(items);
+    buildRankTree(idx);
+    return idx;
+}
+
+// prvi unos ciji kljuc nije manji od prefiksa (strict = 1: prvi koji ne pocinje prefiksom)
+static int lowerBound(NameIndex *idx, const char *prefix, size_t len, int strict) {
+    int lo = 0, hi = idx->numEntries;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        int c = strncmp(idx->entries[mid].key, prefix, len);
+        if (c < 0 || (strict && c == 0)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// trenutni najbolji kandidati, sortirani po rangu
+typedef struct {
+    const NameIndex *idx;
+    int skip;   // tacno poklapanje, vec upisano ispred
+    int limit;
+    int count;
+    int best[COMPLETE_MAX_RESULTS];
+} TopK;
+
+// 0 ako unos ne ulazi u top-k (ni jedan losiji iz iste sortirane liste nece)
+static int offerEntry(TopK *t, int e) {
+    const int *rank = t->idx->rank;
+    if (t->count == t->limit && rank[e] >= rank[t->best[t->limit - 1]]) return 0;
+    if (e == t->skip) return 1;
+
+    int pos = t->count < t->limit ? t->count++ : t->limit - 1;
+    while (pos > 0 && rank[e] < rank[t->best[pos - 1]]) {
+        t->best[pos] = t->best[pos - 1];
+        pos--;
+    }
+    t->best[pos] = e;
+    return 1;
+}
+
+static void offerRange(TopK *t, int from, int to) {
+    for (int i = from; i < to; i++) offerEntry(t, i);
+}
+
+static void offerNode(TopK *t, int v) {
+    const int *list = t->idx->blockTop + (size_t) v * COMPLETE_MAX_RESULTS;
+    for (int i = 0; i < COMPLETE_MAX_RESULTS && list[i] != -1; i++) {
+        if (!offerEntry(t, list[i])) break;
+    }
+}
+
+int completePrefix(NameIndex *idx, const char *prefix, int k, const NameEntry **out) {
+    if (!idx || !prefix || k <= 0) return 0;
+    if (k > COMPLETE_MAX_RESULTS) k = COMPLETE_MAX_RESULTS;
+
+    char key[256];
+    size_t len = strlen(prefix);
+    if (len >= sizeof(key)) len = sizeof(key) - 1;
+    len = normalizeName(prefix, len, key);
+    if (len == 0) return 0; // prazan prefiks bi vratio cijeli rjecnik
+
+    int from = lowerBound(idx, key, len, 0);
+    int to = lowerBound(idx, key, len, 1);
+    if (from >= to) return 0;
+
+    // tacno poklapanje je najkraci kljuc u opsegu, dakle prvi
+    int count = 0;
+    TopK t;
+    t.idx = idx;
+    t.skip = -1;
+    if (idx->entries[from].key[len] == '\0') {
+        out[count++] = &idx->entries[from];
+        t.skip = from;
+    }
+    t.limit = k - count;
+    t.count = 0;
+    if (t.limit == 0) return count;
+
+    // krajnji blokovi djelimicno, a cijeli blokovi izmedju preko stabla
+    int firstBlock = from / NAME_BLOCK_SIZE;
+    int lastBlock = (to - 1) / NAME_BLOCK_SIZE;
+    if (firstBlock == lastBlock) {
+        offerRange(&t, from, to);
+    }
+    else {
+        offerRange(&t, from, (firstBlock + 1) * NAME_BLOCK_SIZE);
+        offerRange(&t, lastBlock * NAME_BLOCK_SIZE, to);
+        int l = idx->numLeaves + firstBlock + 1;
+        int r = idx->numLeaves + lastBlock;
+        while (l < r) {
+            if (l & 1) offerNode(&t, l++);
+            if (r & 1) offerNode(&t, --r);
+            l /= 2;
+            r /= 2;
+        }
+    }
+
+    for (int i = 0; i < t.count; i++) out[count++] = &idx->entries[t.best[i]];
+    return count;
+}
+
+void freeNameIndex(NameIndex *idx) {
+    if (!idx) return;
+    free(idx->entries);
+    free(idx->nodes);
+    free(idx->arena);
+    free(idx->rank);
+    free(idx->blockTop);
+    free(idx);
+}
@@ -0,0 +1,39 @@
+#ifndef AUTOCOMPLETE_H
+#define AUTOCOMPLETE_H
+
+#include "../model/graph.h"
+
+// Jedno ime u rjecniku: sva imena cvorova (i svaka varijanta "A / B") se normalizuju,
+// sortiraju i spajaju, a svaki unos pokazuje na cvorove koji nose to ime.
+typedef struct NameEntry {
+    const char *key;  // normalizovano ime (kljuc za pretragu po prefiksu)
+    const char *name; // ime za prikaz (prvo pojavljivanje)
+    int firstNode;    // pocetak liste cvorova u NameIndex.nodes
+    int nodeCount;
+} NameEntry;
+
+// Najvise dopuna po upitu (k vece od ovoga se svodi na njega)
+#define COMPLETE_MAX_RESULTS 16
+
+typedef struct NameIndex {
+    NameEntry *entries; // sortirano po kljucu
+    int numEntries;
+    int *nodes;         // indeksi cvorova, grupisani po unosu
+    char *arena;        // tekst svih kljuceva i imena
+    int *rank;          // poredak unosa po kvalitetu (vise cvorova, pa kraci kljuc)
+    int *blockTop;      // stablo nad blokovima unosa: najboljih COMPLETE_MAX_RESULTS po cvoru
+    int numLeaves;      // broj listova stabla (stepen dvojke >= broj blokova)
+} NameIndex;
+
+// Gradi se jednom nakon ucitavanja (i preslagivanja) grafa
+NameIndex* buildNameIndex(Graph *g);
+
+// Do k najboljih dopuna za prefiks: tacno poklapanje prvo, zatim imena sa vise
+// cvorova, pa kraca. Cijena ne zavisi od broja poklapanja: krajevi opsega se
+// skeniraju, a sredina se uzima iz O(log n) cvorova stabla blokova. Prazan
+// prefiks se odbija. Vraca broj upisanih unosa u out.
+int completePrefix(NameIndex *idx, const char *prefix, int k, const NameEntry **out);
+
+void freeNameIndex(NameIndex *idx);
+
+#endif
@@ -0,0 +1,243 @@
+#include "deltastep.h"
+#include <stdlib.h>
+#include <float.h>
+#include <limits.h>
+
+typedef struct {
+    int *items;
+    int size;
+    int capacity;
+} IntVec;
+
+// zahtjev za opustanje ivice from -> node, salje se niti koja je vlasnik cvora node
+typedef struct {
+    int node;
+    int from;
+    int edge;
+    double dist;
+    double fromDist;
+} Request;
+
+typedef struct {
+    Request *items;
+    int size;
+    int capacity;
+} RequestVec;
+
+typedef struct {
+    IntVec *buckets;  // kante sa cvorovima ove niti
+    int numBuckets;
+    IntVec frontier;  // cvorovi tekuce kante u ovom krugu
+    IntVec settled;   // svi cvorovi izvuceni iz tekuce kante (za teske ivice)
+    long localMin;
+    int hasWork;
+} ThreadState;
+
+typedef struct {
+    Graph *g;
+    ThreadPool *pool;
+    int source;
+    double delta;
+    ThreadState *threads;
+    RequestVec *outbox;  // outbox[posiljalac * numThreads + vlasnik]
+    int *frontierStamp;
+    int *settledStamp;
+} DeltaContext;
+
+static void intVecPush(IntVec *v, int x) {
+    if (v->size == v->capacity) {
+        v->capacity = v->capacity ? v->capacity * 2 : 64;
+        v->items = (int*) realloc(v->items, v->capacity * sizeof(int));
+    }
+    v->items[v->size++] = x;
+}
+
+static void bucketPush(ThreadState *ts, long bucket, int node) {
+    if (bucket >= ts->numBuckets) {
+        int newCount = ts->numBuckets ? ts->numBuckets : 64;
+        while (newCount <= bucket) newCount *= 2;
+        ts->buckets = (IntVec*) realloc(ts->buckets, newCount * sizeof(IntVec));
+        for (int i = ts->numBuckets; i < newCount; i++) {
+            ts->buckets[i].items = NULL;
+            ts->buckets[i].size = 0;
+            ts->buckets[i].capacity = 0;
+        }
+        ts->numBuckets = newCount;
+    }
+    intVecPush(&ts->buckets[bucket], node);
+}
+
+static void sendRequest(DeltaContext *ctx, int threadId, int numThreads, int node, int from, int edge,
+                        double dist, double fromDist) {
+    RequestVec *rv = &ctx->outbox[threadId * numThreads + node % numThreads];
+    if (rv->size == rv->capacity) {
+        rv->capacity = rv->capacity ? rv->capacity * 2 : 64;
+        rv->items = (Request*) realloc(rv->items, rv->capacity * sizeof(Request));
+    }
+    Request *r = &rv->items[rv->size++];
+    r->node = node;
+    r->from = from;
+    r->edge = edge;
+    r->dist = dist;
+    r->fromDist = fromDist;
+}
+
+// vlasnik primjenjuje sve zahtjeve za svoje cvorove
+static void applyRequests(DeltaContext *ctx, int threadId, int numThreads) {
+    double *dist = ctx->g->dist;
+    int *parent = ctx->g->parent;
+    int *parentEdge = ctx->g->parentEdge;
+    ThreadState *ts = &ctx->threads[threadId];
+
+    for (int s = 0; s < numThreads; s++) {
+        RequestVec *rv = &ctx->outbox[s * numThreads + threadId];
+        for (int i = 0; i < rv->size; i++) {
+            Request *r = &rv->items[i];
+            if (r->dist < dist[r->node]) {
+                dist[r->node] = r->dist;
+                parent[r->node] = r->from;
+                parentEdge[r->node] = r->edge;
+                bucketPush(ts, (long) (r->dist / ctx->delta), r->node);
+            }
+            else if (r->dist == dist[r->node] && r->fromDist < r->dist && r->from < parent[r->node]) {
+                parent[r->node] = r->from; // jednoznacan roditelj kod jednakih duzina
+                parentEdge[r->node] = r->edge;
+            }
+        }
+        rv->size = 0;
+    }
+}
+
+static void sendEdges(DeltaContext *ctx, int threadId, int numThreads, int v, int light) {
+    Graph *g = ctx->g;
+    double dv = g->dist[v];
+    for (int k = g->firstEdge[v]; k != -1; k = g->edges[k].next) {
+        Edge *e = &g->edges[k];
+        double w = edgeWeight(e);
+        if ((w <= ctx->delta) == light) {
+            sendRequest(ctx, threadId, numThreads, e->target, v, k, dv + w, dv);
+        }
+    }
+}
+
+static void deltaTask(void *arg, int threadId, int numThreads) {
+    DeltaContext *ctx = (DeltaContext*) arg;
+    Graph *g = ctx->g;
+    ThreadState *ts = &ctx->threads[threadId];
+
+    for (int v = threadId; v < g->numNodes; v += numThreads) {
+        g->dist[v] = DBL_MAX;
+        g->parent[v] = -1;
+        g->parentEdge[v] = -1;
+        ctx->frontierStamp[v] = -1;
+        ctx->settledStamp[v] = -1;
+    }
+    poolBarrier(ctx->pool);
+
+    if (ctx->source % numThreads == threadId) {
+        g->dist[ctx->source] = 0;
+        bucketPush(ts, 0, ctx->source);
+    }
+
+    long current = 0;
+    int round = 0;
+    while (1) {
+        // sljedeca neprazna kanta (minimum preko svih niti)
+        ts->localMin = LONG_MAX;
+        for (long b = current; b < ts->numBuckets; b++) {
+            if (ts->buckets[b].size > 0) {
+                ts->localMin = b;
+                break;
+            }
+        }
+        poolBarrier(ctx->pool);
+
+        long next = LONG_MAX;
+        for (int t = 0; t < numThreads; t++) {
+            if (ctx->threads[t].localMin < next) next = ctx->threads[t].localMin;
+        }
+        if (next == LONG_MAX) break;
+        current = next;
+        ts->settled.size = 0;
+
+        // lake ivice: ponavljaj dok se kanta ne isprazni kod svih niti
+        while (1) {
+            round++;
+            ts->frontier.size = 0;
+            if (current < ts->numBuckets) {
+                IntVec *bucket = &ts->buckets[current];
+                for (int i = 0; i < bucket->size; i++) {
+                    int v = bucket->items[i];
+                    // preskoci duplikate i zastarjele unose (cvor vec premjesten u raniju kantu)
+                    if (ctx->frontierStamp[v] != round && (long) (g->dist[v] / ctx->delta) == current) {
+                        ctx->frontierStamp[v] = round;
+                        intVecPush(&ts->frontier, v);
+                    }
+                }
+                bucket->size = 0;
+            }
+            ts->hasWork = ts->frontier.size > 0;
+            poolBarrier(ctx->pool);
+
+            int anyWork = 0;
+            for (int t = 0; t < numThreads; t++) anyWork |= ctx->threads[t].hasWork;
+            if (!anyWork) break;
+
+            for (int i = 0; i < ts->frontier.size; i++) {
+                int v = ts->frontier.items[i];
+                if (ctx->settledStamp[v] != current) {
+                    ctx->settledStamp[v] = (int) current;
+                    intVecPush(&ts->settled, v);
+                }
+                sendEdges(ctx, threadId, numThreads, v, 1);
+            }
+            poolBarrier(ctx->pool);
+            applyRequests(ctx, threadId, numThreads);
+        }
+
+        // teske ivice se opustaju jednom za sve cvorove kante
+        for (int i = 0; i < ts->settled.size; i++) {
+            sendEdges(ctx, threadId, numThreads, ts->settled.items[i], 0);
+        }
+        poolBarrier(ctx->pool);
+        applyRequests(ctx, threadId, numThreads);
+        current++;
+    }
+}
+
+void computeShortestPathTreeParallel(Graph *g, ThreadPool *pool, int source, double delta) {
+    int numThreads = pool->numThreads;
+
+    if (delta <= 0) {
+        // nekoliko prosjecnih ivica po kanti: dovoljno posla po krugu, a malo ponovnih opustanja
+        double total = 0;
+        for (int i = 0; i < g->numEdges; i++) total += edgeWeight(&g->edges[i]);
+        delta = g->numEdges > 0 ? 4 * total / g->numEdges : 1;
+        if (delta <= 0) delta = 1;
+    }
+
+    DeltaContext ctx;
+    ctx.g = g;
+    ctx.pool = pool;
+    ctx.source = source;
+    ctx.delta = delta;
+    ctx.threads = (ThreadState*) calloc(numThreads, sizeof(ThreadState));
+    ctx.outbox = (RequestVec*) calloc((size_t) numThreads * numThreads, sizeof(RequestVec));
+    ctx.frontierStamp = (int*) malloc(g->numNodes * sizeof(int));
+    ctx.settledStamp = (int*) malloc(g->numNodes * sizeof(int));
+
+    runOnPool(pool, deltaTask, &ctx);
+
+    for (int t = 0; t < numThreads; t++) {
+        ThreadState *ts = &ctx.threads[t];
+        for (int b = 0; b < ts->numBuckets; b++) free(ts->buckets[b].items);
+        free(ts->buckets);
+        free(ts->frontier.items);
+        free(ts->settled.items);
+    }
+    for (int i = 0; i < numThreads * numThreads; i++) free(ctx.outbox[i].items);
+    free(ctx.threads);
+    free(ctx.outbox);
+    free(ctx.frontierStamp);
+    free(ctx.settledStamp);
+}
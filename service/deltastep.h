@@ -0,0 +1,17 @@
+#ifndef DELTASTEP_H
+#define DELTASTEP_H
+
+#include "../model/graph.h"
+#include "../utils/threadpool.h"
+
+// Paralelna Dijkstra od jednog izvora do svih cvorova (delta-stepping).
+// Cvorovi su u "kantama" sirine delta metara; lake ivice (<= delta) se opustaju
+// u vise krugova unutar kante, teske jednom kad se kanta isprazni. Svaka nit je
+// vlasnik cvorova v sa v % numThreads == threadId i jedina mijenja njihovo stanje.
+// Rezultat ostaje u g->dist, g->parent i g->parentEdge, isto kao kod computeShortestPathTree
+// (udaljenosti su identicne; roditelj se kod jednakih duzina bira po najmanjem indeksu,
+// pa se razlikuje samo kod ivica nulte duzine).
+// delta <= 0 bira sirinu kante automatski.
+void computeShortestPathTreeParallel(Graph *g, ThreadPool *pool, int source, double delta);
+
+#endif
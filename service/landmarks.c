@@ -0,0 +1,230 @@
+#include "landmarks.h"
+#include "deltastep.h"
+#include "../utils/cpu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+
+#define LANDMARK_MAGIC "ALT1"
+#define LANDMARK_VERSION 2 // 2: kontrolni zbir obuhvata ivice i tip tezine
+
+// provjerava da li za svaku ivicu u->v postoji ivica v->u iste tezine
+static int isSymmetric(Graph *g) {
+    for (int u = 0; u < g->numNodes; u++) {
+        for (Edge *e = firstEdge(g, u); e != NULL; e = nextEdge(g, e)) {
+            int found = 0;
+            for (Edge *back = firstEdge(g, e->target); back != NULL; back = nextEdge(g, back)) {
+                if (back->target == u && back->weight == e->weight) {
+                    found = 1;
+                    break;
+                }
+            }
+            if (!found) return 0;
+        }
+    }
+    return 1;
+}
+
+// stablo najkracih puteva; paralelno (delta-stepping) ako ima vise procesora
+static void computeTree(Graph *g, ThreadPool *pool, int source) {
+    if (pool) computeShortestPathTreeParallel(g, pool, source, 0);
+    else computeShortestPathTree(g, source);
+}
+
+// kopira rezultat Dijkstre (g->dist) u tabelu orijentira
+static double copyDistances(Graph *g, float *out) {
+    double maxDist = 0;
+    for (int v = 0; v < g->numNodes; v++) {
+        if (g->dist[v] == DBL_MAX) {
+            out[v] = INFINITY;
+        }
+        else {
+            out[v] = (float) g->dist[v];
+            if (g->dist[v] > maxDist) maxDist = g->dist[v];
+        }
+    }
+    return maxDist;
+}
+
+static Landmarks* allocLandmarks(int k, int numNodes, int symmetric) {
+    Landmarks *lm = (Landmarks*) calloc(1, sizeof(Landmarks));
+    lm->k = k;
+    lm->numNodes = numNodes;
+    lm->nodes = (int*) malloc(k * sizeof(int));
+    lm->fromDist = (float*) malloc((size_t) k * numNodes * sizeof(float));
+    lm->toDist = symmetric ? lm->fromDist : (float*) malloc((size_t) k * numNodes * sizeof(float));
+    if (!lm->nodes || !lm->fromDist || !lm->toDist) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za %d orijentira\n", k);
+        freeLandmarks(lm);
+        return NULL;
+    }
+    return lm;
+}
+
+Landmarks* buildLandmarks(Graph *g, int k) {
+    if (k <= 0 || g->numNodes == 0) return NULL;
+
+    int symmetric = isSymmetric(g);
+    Landmarks *lm = allocLandmarks(k, g->numNodes, symmetric);
+    if (!lm) return NULL;
+
+    Graph *reverse = symmetric ? NULL : createReverseGraph(g);
+    if (!symmetric && !reverse) {
+        freeLandmarks(lm);
+        return NULL;
+    }
+    ThreadPool *pool = cpuCount() > 1 ? createThreadPool(cpuCount()) : NULL;
+
+    // minDist[v] = udaljenost od v do najblizeg vec izabranog orijentira
+    double *minDist = (double*) malloc(g->numNodes * sizeof(double));
+    for (int v = 0; v < g->numNodes; v++) minDist[v] = DBL_MAX;
+
+    // pocetna tacka: prvi cvor koji je dio putne mreze; prvi orijentir je od njega najdalji
+    int current = 0;
+    while (current < g->numNodes - 1 && !nodeHasEdges(g, current)) current++;
+    computeTree(g, pool, current);
+
+    double maxDist = 0;
+    for (int l = 0; l < k; l++) {
+        int best = -1;
+        double bestDist = -1;
+        for (int v = 0; v < g->numNodes; v++) {
+            double d = l == 0 ? g->dist[v] : minDist[v];
+            if (d != DBL_MAX && d > bestDist && nodeHasEdges(g, v)) {
+                bestDist = d;
+                best = v;
+            }
+        }
+        if (best == -1) best = current;
+        lm->nodes[l] = best;
+
+        computeTree(g, pool, best);
+        double m = copyDistances(g, lm->fromDist + (size_t) l * g->numNodes);
+        if (m > maxDist) maxDist = m;
+        for (int v = 0; v < g->numNodes; v++) {
+            if (g->dist[v] < minDist[v]) minDist[v] = g->dist[v];
+        }
+
+        if (!symmetric) {
+            computeTree(reverse, pool, best);
+            m = copyDistances(reverse, lm->toDist + (size_t) l * g->numNodes);
+            if (m > maxDist) maxDist = m;
+        }
+    }
+
+    // dvije vrijednosti zaokruzene na float: greska najvise 2 * pola ulp-a najvece udaljenosti
+    lm->slack = 2 * maxDist * FLT_EPSILON;
+
+    free(minDist);
+    if (pool) freeThreadPool(pool);
+    if (reverse) freeGraph(reverse);
+    return lm;
+}
+
+int saveLandmarks(Graph *g, Landmarks *lm, const char *filename) {
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) {
+        fprintf(stderr, "Greska: nije moguce upisati fajl \"%s\"\n", filename);
+        return -1;
+    }
+
+    int32_t version = LANDMARK_VERSION;
+    int32_t header[3] = {lm->k, lm->numNodes, lm->toDist == lm->fromDist};
+    uint64_t checksum = graphChecksum(g);
+    size_t tableSize = (size_t) lm->k * lm->numNodes;
+
+    int ok = fwrite(LANDMARK_MAGIC, 1, 4, fp) == 4 &&
+             fwrite(&version, sizeof(int32_t), 1, fp) == 1 &&
+             fwrite(header, sizeof(int32_t), 3, fp) == 3 &&
+             fwrite(&checksum, sizeof(checksum), 1, fp) == 1 &&
+             fwrite(&lm->slack, sizeof(double), 1, fp) == 1 &&
+             fwrite(lm->nodes, sizeof(int), lm->k, fp) == (size_t) lm->k &&
+             fwrite(lm->fromDist, sizeof(float), tableSize, fp) == tableSize;
+    if (ok && lm->toDist != lm->fromDist) {
+        ok = fwrite(lm->toDist, sizeof(float), tableSize, fp) == tableSize;
+    }
+
+    fclose(fp);
+    return ok ? 0 : -1;
+}
+
+Landmarks* loadLandmarks(Graph *g, const char *filename) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return NULL;
+
+    char magic[4];
+    int32_t version;
+    int32_t header[3];
+    uint64_t checksum;
+    double slack;
+    if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, LANDMARK_MAGIC, 4) != 0 ||
+        fread(&version, sizeof(int32_t), 1, fp) != 1 || version != LANDMARK_VERSION ||
+        fread(header, sizeof(int32_t), 3, fp) != 3 ||
+        fread(&checksum, sizeof(checksum), 1, fp) != 1 ||
+        fread(&slack, sizeof(double), 1, fp) != 1 ||
+        header[0] <= 0 || header[1] != g->numNodes || checksum != graphChecksum(g)) {
+        fclose(fp);
+        return NULL;
+    }
+
+    Landmarks *lm = allocLandmarks(header[0], header[1], header[2]);
+    if (!lm) {
+        fclose(fp);
+        return NULL;
+    }
+    lm->slack = slack;
+
+    size_t tableSize = (size_t) lm->k * lm->numNodes;
+    int ok = fread(lm->nodes, sizeof(int), lm->k, fp) == (size_t) lm->k &&
+             fread(lm->fromDist, sizeof(float), tableSize, fp) == tableSize;
+    if (ok && lm->toDist != lm->fromDist) {
+        ok = fread(lm->toDist, sizeof(float), tableSize, fp) == tableSize;
+    }
+    fclose(fp);
+
+    if (!ok) {
+        freeLandmarks(lm);
+        return NULL;
+    }
+    return lm;
+}
+
+// donja granica d(node, target) po nejednakosti trougla
+static double landmarkBound(Graph *g, int node, int target, void *ctx) {
+    (void) g;
+    Landmarks *lm = (Landmarks*) ctx;
+    double best = 0;
+    for (int l = 0; l < lm->k; l++) {
+        const float *from = lm->fromDist + (size_t) l * lm->numNodes;
+        const float *to = lm->toDist + (size_t) l * lm->numNodes;
+
+        // d(L, t) - d(L, v)
+        if (!isinf(from[target]) && !isinf(from[node])) {
+            double b = (double) from[target] - from[node];
+            if (b > best) best = b;
+        }
+        // d(v, L) - d(t, L)
+        if (!isinf(to[node]) && !isinf(to[target])) {
+            double b = (double) to[node] - to[target];
+            if (b > best) best = b;
+        }
+    }
+    best -= lm->slack;
+    return best > 0 ? best : 0;
+}
+
+PathResult findShortestPathALT(Graph *g, Landmarks *lm, long long startNodeId, long long endNodeId,
+                               const SearchLimits *limits) {
+    return findShortestPathLimited(g, startNodeId, endNodeId, landmarkBound, lm, limits);
+}
+
+void freeLandmarks(Landmarks *lm) {
+    if (!lm) return;
+    if (lm->toDist != lm->fromDist) free(lm->toDist);
+    free(lm->fromDist);
+    free(lm->nodes);
+    free(lm);
+}
@@ -0,0 +1,32 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "../model/graph.h"
+#include "pathfinder.h"
+
+// ALT (A*, Landmarks, Triangle inequality): za k orijentira L cuvaju se udaljenosti
+// d(L, v) i d(v, L) za svaki cvor v, a donja granica udaljenosti do cilja t je
+// max(d(L, t) - d(L, v), d(v, L) - d(t, L)). Memorija: k * n * 4 bajta po smjeru.
+typedef struct Landmarks {
+    int k;
+    int numNodes;
+    int *nodes;       // indeksi orijentira
+    float *fromDist;  // fromDist[l * numNodes + v] = d(L_l, v)
+    float *toDist;    // toDist[l * numNodes + v] = d(v, L_l); isti niz kao fromDist ako je graf simetrican
+    double slack;     // greska zaokruzivanja na float, oduzima se od granice
+} Landmarks;
+
+// Bira k orijentira ("farthest" izbor) i racuna tabele udaljenosti
+Landmarks* buildLandmarks(Graph *g, int k);
+
+// Cuva/ucitava tabele; ucitavanje ne uspijeva ako fajl ne odgovara grafu
+int saveLandmarks(Graph *g, Landmarks *lm, const char *filename);
+Landmarks* loadLandmarks(Graph *g, const char *filename);
+
+// A* sa ALT donjim granicama (limits moze biti NULL)
+PathResult findShortestPathALT(Graph *g, Landmarks *lm, long long startNodeId, long long endNodeId,
+                               const SearchLimits *limits);
+
+void freeLandmarks(Landmarks *lm);
+
+#endif
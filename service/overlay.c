@@ -0,0 +1,830 @@
+#define _FILE_OFFSET_BITS 64
+#include "overlay.h"
+#include "../utils/geometry.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+
+#define OVERLAY_MAGIC "CRP1"
+#define OVERLAY_VERSION 3   // 3: trazeni broj nivoa u zaglavlju
+#define INDEX_OFFSET_POS 36 // magic + 6 * int32 + checksum
+
+// fajl moze biti veci od 2 GB
+#ifdef _WIN32
+#define seekFile(fp, pos) _fseeki64(fp, (long long) (pos), SEEK_SET)
+#define tellFile(fp) _ftelli64(fp)
+#else
+#define seekFile(fp, pos) fseeko(fp, (off_t) (pos), SEEK_SET)
+#define tellFile(fp) ((long long) ftello(fp))
+#endif
+
+typedef struct {
+    int *items;
+    int size;
+    int capacity;
+} IntVec;
+
+static void intVecPush(IntVec *v, int x) {
+    if (v->size == v->capacity) {
+        v->capacity = v->capacity ? v->capacity * 2 : 64;
+        v->items = (int*) realloc(v->items, v->capacity * sizeof(int));
+    }
+    v->items[v->size++] = x;
+}
+
+static inline uint32_t cellOf(Overlay *ov, int level, int v) {
+    return ov->cellCode[v] >> ov->levels[level].shift;
+}
+
+// ---------------------------------------------------------------------------
+// Particionisanje: rekurzivna bisekcija po koordinatama
+
+typedef struct {
+    double key;
+    int node;
+} SplitKey;
+
+typedef struct {
+    Graph *g;
+    int depth;          // broj bisekcija do celija najnizeg nivoa
+    uint32_t *cellCode;
+    int *mark;          // strana cvora u tekucoj bisekciji
+    int token;
+    SplitKey *keys;     // radni nizovi (tekuci i najbolji pravac)
+    SplitKey *bestKeys;
+} Partitioner;
+
+static int compareSplitKeys(const void *a, const void *b) {
+    const SplitKey *x = (const SplitKey*) a;
+    const SplitKey *y = (const SplitKey*) b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->node - y->node;
+}
+
+// broj ivica izmedju dvije polovine sortiranog niza
+static long countCut(Partitioner *p, SplitKey *keys, int count) {
+    int left = ++p->token;
+    int right = ++p->token;
+    for (int i = 0; i < count; i++) p->mark[keys[i].node] = i < count / 2 ? left : right;
+
+    long cut = 0;
+    for (int i = 0; i < count; i++) {
+        int u = keys[i].node;
+        for (int k = p->g->firstEdge[u]; k != -1; k = p->g->edges[k].next) {
+            int m = p->mark[p->g->edges[k].target];
+            if ((m == left || m == right) && m != p->mark[u]) cut++;
+        }
+    }
+    return cut;
+}
+
+// dijeli cvorove na dvije jednake polovine po sirini, duzini ili jednoj od dijagonala,
+// birajuci pravac sa najmanjim rezom, sve dok se ne dostigne dubina celija
+static void bisect(Partitioner *p, int *nodes, int count, int depth, uint32_t code) {
+    if (depth == p->depth) {
+        for (int i = 0; i < count; i++) p->cellCode[nodes[i]] = code;
+        return;
+    }
+
+    long bestCut = -1;
+    for (int dir = 0; dir < 4; dir++) {
+        for (int i = 0; i < count; i++) {
+            double lat = p->g->lat[nodes[i]];
+            double lon = p->g->lon[nodes[i]];
+            p->keys[i].key = dir == 0 ? lat : dir == 1 ? lon : dir == 2 ? lat + lon : lat - lon;
+            p->keys[i].node = nodes[i];
+        }
+        qsort(p->keys, count, sizeof(SplitKey), compareSplitKeys);
+        long cut = countCut(p, p->keys, count);
+        if (bestCut == -1 || cut < bestCut) {
+            bestCut = cut;
+            SplitKey *t = p->keys;
+            p->keys = p->bestKeys;
+            p->bestKeys = t;
+        }
+    }
+    for (int i = 0; i < count; i++) nodes[i] = p->bestKeys[i].node;
+
+    int half = count / 2;
+    bisect(p, nodes, half, depth + 1, code << 1);
+    bisect(p, nodes + half, count - half, depth + 1, (code << 1) | 1);
+}
+
+static void partitionGraph(Graph *g, Overlay *ov, int depth) {
+    Partitioner p;
+    p.g = g;
+    p.depth = depth;
+    p.cellCode = ov->cellCode;
+    p.mark = (int*) calloc(g->numNodes, sizeof(int));
+    p.token = 0;
+    p.keys = (SplitKey*) malloc(g->numNodes * sizeof(SplitKey));
+    p.bestKeys = (SplitKey*) malloc(g->numNodes * sizeof(SplitKey));
+
+    int *nodes = (int*) malloc(g->numNodes * sizeof(int));
+    for (int i = 0; i < g->numNodes; i++) nodes[i] = i;
+    bisect(&p, nodes, g->numNodes, 0, 0);
+
+    free(nodes);
+    free(p.mark);
+    free(p.keys);
+    free(p.bestKeys);
+}
+
+// granicni cvorovi nivoa: krajevi ivica ciji su krajevi u razlicitim celijama
+static void computeBoundaries(Graph *g, Overlay *ov, int level) {
+    OverlayLevel *lv = &ov->levels[level];
+    unsigned char *isBoundary = (unsigned char*) calloc(g->numNodes, 1);
+    for (int u = 0; u < g->numNodes; u++) {
+        for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) {
+            int v = g->edges[k].target;
+            if (cellOf(ov, level, u) != cellOf(ov, level, v)) {
+                isBoundary[u] = 1;
+                isBoundary[v] = 1;
+            }
+        }
+    }
+
+    lv->boundaryStart = (int*) calloc(lv->numCells + 1, sizeof(int));
+    for (int v = 0; v < g->numNodes; v++) {
+        if (isBoundary[v]) lv->boundaryStart[cellOf(ov, level, v) + 1]++;
+    }
+    for (int c = 0; c < lv->numCells; c++) lv->boundaryStart[c + 1] += lv->boundaryStart[c];
+
+    int *fill = (int*) malloc(lv->numCells * sizeof(int));
+    memcpy(fill, lv->boundaryStart, lv->numCells * sizeof(int));
+    lv->boundary = (int*) malloc((lv->boundaryStart[lv->numCells] + 1) * sizeof(int));
+    for (int v = 0; v < g->numNodes; v++) {
+        if (isBoundary[v]) lv->boundary[fill[cellOf(ov, level, v)]++] = v;
+    }
+
+    free(fill);
+    free(isBoundary);
+}
+
+// polozaj cvora v u listi granicnih cvorova celije ili -1
+static int boundaryIndex(OverlayLevel *lv, uint32_t cell, int v) {
+    int lo = lv->boundaryStart[cell];
+    int hi = lv->boundaryStart[cell + 1] - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (lv->boundary[mid] == v) return mid - lv->boundaryStart[cell];
+        if (lv->boundary[mid] < v) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Kes redova matrica (LRU)
+
+static void lruUnlink(Overlay *ov, int slot) {
+    CliqueEntry *e = &ov->entries[slot];
+    if (e->prev != -1) ov->entries[e->prev].next = e->next;
+    else ov->lruHead = e->next;
+    if (e->next != -1) ov->entries[e->next].prev = e->prev;
+    else ov->lruTail = e->prev;
+}
+
+static void lruPushFront(Overlay *ov, int slot) {
+    CliqueEntry *e = &ov->entries[slot];
+    e->prev = -1;
+    e->next = ov->lruHead;
+    if (ov->lruHead != -1) ov->entries[ov->lruHead].prev = slot;
+    ov->lruHead = slot;
+    if (ov->lruTail == -1) ov->lruTail = slot;
+}
+
+static void evictClique(Overlay *ov, int slot) {
+    CliqueEntry *e = &ov->entries[slot];
+    lruUnlink(ov, slot);
+    ov->levels[e->level].rowSlot[e->boundaryPos] = -1;
+    ov->usedBytes -= e->bytes;
+    free(e->row);
+    e->row = NULL;
+    e->next = ov->freeEntry;
+    ov->freeEntry = slot;
+}
+
+static int allocEntry(Overlay *ov) {
+    if (ov->freeEntry != -1) {
+        int slot = ov->freeEntry;
+        ov->freeEntry = ov->entries[slot].next;
+        return slot;
+    }
+    if (ov->numEntries == ov->entryCapacity) {
+        ov->entryCapacity = ov->entryCapacity ? ov->entryCapacity * 2 : 64;
+        ov->entries = (CliqueEntry*) realloc(ov->entries, ov->entryCapacity * sizeof(CliqueEntry));
+    }
+    return ov->numEntries++;
+}
+
+// red i matrice celije (cita se iz fajla ako nije u kesu; pretraga treba samo red
+// cvora koji obradjuje). Pokazivac vazi do sljedeceg poziva.
+// NULL i ov->ioError = 1 ako citanje ne uspije.
+static const double* getCliqueRow(Overlay *ov, int level, uint32_t cell, int i) {
+    OverlayLevel *lv = &ov->levels[level];
+    int pos = lv->boundaryStart[cell] + i;
+    int b = lv->boundaryStart[cell + 1] - lv->boundaryStart[cell];
+
+    int slot = lv->rowSlot[pos];
+    if (slot != -1) {
+        ov->cacheHits++;
+        lruUnlink(ov, slot);
+        lruPushFront(ov, slot);
+        return ov->entries[slot].row;
+    }
+
+    ov->cacheMisses++;
+    size_t bytes = (size_t) b * sizeof(double);
+    while (ov->usedBytes + bytes > ov->cacheBytes && ov->lruTail != -1) {
+        evictClique(ov, ov->lruTail);
+    }
+
+    double *row = (double*) malloc(bytes);
+    if (!row || seekFile(ov->fp, lv->cliqueOffset[cell] + (long long) i * bytes) != 0 ||
+        fread(row, 1, bytes, ov->fp) != bytes) {
+        fprintf(stderr, "Greska: nije moguce ucitati matricu celije %u (nivo %d)\n", cell, level);
+        free(row);
+        ov->ioError = 1;
+        return NULL;
+    }
+
+    slot = allocEntry(ov);
+    CliqueEntry *e = &ov->entries[slot];
+    e->level = level;
+    e->boundaryPos = pos;
+    e->row = row;
+    e->bytes = bytes;
+    lruPushFront(ov, slot);
+    lv->rowSlot[pos] = slot;
+    ov->usedBytes += bytes;
+    return row;
+}
+
+// ---------------------------------------------------------------------------
+// Pretraga
+
+typedef struct {
+    int source;
+    int target;         // -1: do iscrpljivanja
+    int regionLevel;    // pretraga ostaje u celiji regionCell ovog nivoa; 0 = cijeli graf
+    uint32_t regionCell;
+    int scanLevel;      // nivo na kome se obradjuju cvorovi; -1 = po upitu (queryLevel)
+} SearchMode;
+
+static void newSearch(OverlaySearch *s, int numNodes) {
+    if (s->current == INT_MAX) {
+        memset(s->stamp, 0, numNodes * sizeof(int));
+        memset(s->settledStamp, 0, numNodes * sizeof(int));
+        s->current = 0;
+    }
+    s->current++;
+    s->heapSize = 0;
+}
+
+static inline double searchDist(OverlaySearch *s, int v) {
+    return s->stamp[v] == s->current ? s->dist[v] : DBL_MAX;
+}
+
+// binarni heap sa pozicijama cvorova: svaki cvor je u heapu najvise jednom
+static void heapSiftUp(OverlaySearch *s, int i) {
+    int v = s->heap[i];
+    double d = s->dist[v];
+    while (i > 0) {
+        int p = (i - 1) / 2;
+        if (s->dist[s->heap[p]] <= d) break;
+        s->heap[i] = s->heap[p];
+        s->heapPos[s->heap[i]] = i;
+        i = p;
+    }
+    s->heap[i] = v;
+    s->heapPos[v] = i;
+}
+
+static int heapPopMin(OverlaySearch *s) {
+    int top = s->heap[0];
+    int v = s->heap[--s->heapSize];
+    double d = s->dist[v];
+    int i = 0;
+    while (1) {
+        int c = 2 * i + 1;
+        if (c >= s->heapSize) break;
+        if (c + 1 < s->heapSize && s->dist[s->heap[c + 1]] < s->dist[s->heap[c]]) c++;
+        if (d <= s->dist[s->heap[c]]) break;
+        s->heap[i] = s->heap[c];
+        s->heapPos[s->heap[i]] = i;
+        i = c;
+    }
+    if (s->heapSize > 0) {
+        s->heap[i] = v;
+        s->heapPos[v] = i;
+    }
+    return top;
+}
+
+static inline void relax(OverlaySearch *s, int u, int v, double d, int arcLevel, int edge) {
+    if (s->stamp[v] != s->current) {
+        s->stamp[v] = s->current;
+        s->heapPos[v] = s->heapSize++;
+        s->heap[s->heapPos[v]] = v;
+    }
+    else if (d >= s->dist[v] || s->settledStamp[v] == s->current) {
+        return;
+    }
+    s->dist[v] = d;
+    s->parent[v] = u;
+    s->parentEdge[v] = edge;
+    s->arcLevel[v] = (unsigned char) arcLevel;
+    heapSiftUp(s, s->heapPos[v]);
+}
+
+// najvisi nivo na kome se celija cvora razlikuje i od celije starta i od celije cilja
+static int queryLevel(Overlay *ov, int v, int s, int t) {
+    for (int l = ov->numLevels; l >= 1; l--) {
+        uint32_t c = cellOf(ov, l, v);
+        if (c != cellOf(ov, l, s) && c != cellOf(ov, l, t)) return l;
+    }
+    return 0;
+}
+
+// na nivou 0 cvor koristi sve ivice; na nivou l > 0 kliku svoje celije i ivice koje je napustaju
+static void scanNode(Graph *g, Overlay *ov, SearchMode *m, int u) {
+    OverlaySearch *s = &ov->search;
+    int level = m->scanLevel >= 0 ? m->scanLevel : queryLevel(ov, u, m->source, m->target);
+    double du = s->dist[u];
+
+    if (level > 0) {
+        OverlayLevel *lv = &ov->levels[level];
+        uint32_t cell = cellOf(ov, level, u);
+        int i = boundaryIndex(lv, cell, u);
+        const double *row = i >= 0 ? getCliqueRow(ov, level, cell, i) : NULL;
+        if (row) {
+            int first = lv->boundaryStart[cell];
+            int b = lv->boundaryStart[cell + 1] - first;
+            for (int j = 0; j < b; j++) {
+                if (j != i && !isinf(row[j])) relax(s, u, lv->boundary[first + j], du + row[j], level, -1);
+            }
+        }
+    }
+
+    for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) {
+        Edge *e = &g->edges[k];
+        int v = e->target;
+        if (m->regionLevel > 0 && cellOf(ov, m->regionLevel, v) != m->regionCell) continue;
+        if (level > 0 && cellOf(ov, level, v) == cellOf(ov, level, u)) continue;
+        relax(s, u, v, du + edgeWeight(e), 0, k);
+    }
+}
+
+static int runOverlaySearch(Graph *g, Overlay *ov, SearchMode *m, const SearchLimits *limits, PathStatus *status) {
+    OverlaySearch *s = &ov->search;
+    newSearch(s, ov->numNodes);
+
+    s->stamp[m->source] = s->current;
+    s->dist[m->source] = 0;
+    s->parent[m->source] = -1;
+    s->parentEdge[m->source] = -1;
+    s->arcLevel[m->source] = 0;
+    s->heap[0] = m->source;
+    s->heapPos[m->source] = 0;
+    s->heapSize = 1;
+
+    int settled = 0;
+    while (s->heapSize > 0) {
+        int u = heapPopMin(s);
+        s->settledStamp[u] = s->current;
+        settled++;
+
+        if (u == m->target) break;
+
+        if (limits && (settled % SEARCH_CHECK_INTERVAL == 0 || settled == limits->maxSettled)) {
+            PathStatus stop = checkSearchLimits(limits, settled);
+            if (stop != PATH_OK) {
+                if (status) *status = stop;
+                break;
+            }
+        }
+
+        scanNode(g, ov, m, u);
+        if (ov->ioError) {
+            if (status) *status = PATH_IO_ERROR;
+            break;
+        }
+    }
+    return settled;
+}
+
+static void intVecReverse(IntVec *v) {
+    for (int i = 0, j = v->size - 1; i < j; i++, j--) {
+        int t = v->items[i];
+        v->items[i] = v->items[j];
+        v->items[j] = t;
+    }
+}
+
+// cvorovi, nivoi lukova i ivice (za lukove nivoa 0) od izvora do target-a iz posljednje pretrage
+static void extractPath(Overlay *ov, int target, IntVec *nodes, IntVec *levels, IntVec *edges) {
+    OverlaySearch *s = &ov->search;
+    for (int v = target; v != -1; v = s->parent[v]) {
+        intVecPush(nodes, v);
+        intVecPush(levels, s->arcLevel[v]);
+        intVecPush(edges, s->parentEdge[v]);
+    }
+    intVecReverse(nodes);
+    intVecReverse(levels);
+    intVecReverse(edges);
+}
+
+// zamjenjuje luk nivoa level putem kroz celiju (rekurzivno do ivica grafa);
+// dodaje cvorove poslije from u out i ivice kojima se do njih stiglo u outEdges
+static void unpackArc(Graph *g, Overlay *ov, int from, int to, int level, int edge,
+                      IntVec *out, IntVec *outEdges) {
+    if (level == 0) {
+        intVecPush(out, to);
+        intVecPush(outEdges, edge);
+        return;
+    }
+
+    SearchMode m = {from, to, level, cellOf(ov, level, from), level - 1};
+    runOverlaySearch(g, ov, &m, NULL, NULL);
+    if (ov->ioError) return;
+    if (searchDist(&ov->search, to) == DBL_MAX) {
+        intVecPush(out, to); // ne bi trebalo da se desi: klika je izracunata istom pretragom
+        intVecPush(outEdges, -1);
+        return;
+    }
+
+    IntVec nodes = {0}, levels = {0}, edges = {0};
+    extractPath(ov, to, &nodes, &levels, &edges);
+    for (int i = 1; i < nodes.size; i++) {
+        unpackArc(g, ov, nodes.items[i - 1], nodes.items[i], levels.items[i], edges.items[i], out, outEdges);
+    }
+    free(nodes.items);
+    free(levels.items);
+    free(edges.items);
+}
+
+// putanja od izvora do target-a iz posljednje pretrage, sa raspakovanim precicama;
+// 0 ako citanje matrice tokom raspakivanja nije uspjelo
+static int buildOverlayPath(Graph *g, Overlay *ov, int startNode, int target, PathResult *result) {
+    IntVec nodes = {0}, levels = {0}, edges = {0}, full = {0}, fullEdges = {0};
+    extractPath(ov, target, &nodes, &levels, &edges);
+    intVecPush(&full, startNode);
+    intVecPush(&fullEdges, -1);
+    for (int i = 1; i < nodes.size; i++) {
+        unpackArc(g, ov, nodes.items[i - 1], nodes.items[i], levels.items[i], edges.items[i], &full, &fullEdges);
+    }
+
+    int ok = !ov->ioError;
+    if (ok) {
+        result->pathLength = full.size;
+        result->pathNodes = (long long*) malloc(full.size * sizeof(long long));
+        for (int i = 0; i < full.size; i++) result->pathNodes[i] = g->nodes[full.items[i]].id;
+        result->pathEdges = fullEdges.items; // preuzima niz
+    }
+    else {
+        free(fullEdges.items);
+    }
+
+    free(nodes.items);
+    free(levels.items);
+    free(edges.items);
+    free(full.items);
+    return ok;
+}
+
+static double straightLine(Graph *g, int a, int b) {
+    return calculateDistance(nodeLat(g, a), nodeLon(g, a), nodeLat(g, b), nodeLon(g, b));
+}
+
+// procjena nakon prekida (kao partialEstimate u pathfinder.c): obradjeni cvor najblizi
+// cilju vazdusnom linijom; putanja do njega se raspakuje kroz celije
+static int overlayPartialEstimate(Graph *g, Overlay *ov, int startNode, int endNode, PathResult *result) {
+    OverlaySearch *s = &ov->search;
+    int best = startNode;
+    double bestRest = straightLine(g, startNode, endNode);
+    for (int v = 0; v < ov->numNodes; v++) {
+        if (s->settledStamp[v] != s->current) continue;
+        double rest = straightLine(g, v, endNode);
+        if (rest < bestRest || (rest == bestRest && s->dist[v] < s->dist[best])) {
+            bestRest = rest;
+            best = v;
+        }
+    }
+    result->distance = s->dist[best] + bestRest;
+    return buildOverlayPath(g, ov, startNode, best, result);
+}
+
+PathResult findShortestPathOverlay(Graph *g, Overlay *ov, long long startNodeId, long long endNodeId,
+                                   const SearchLimits *limits) {
+    PathResult result;
+    result.distance = -1;
+    result.pathNodes = NULL;
+    result.pathEdges = NULL;
+    result.pathLength = 0;
+    result.settledNodes = 0;
+    result.status = PATH_NOT_FOUND;
+    result.estimate = FALLBACK_NONE;
+
+    int startNode = findNodeIndex(g, startNodeId);
+    int endNode = findNodeIndex(g, endNodeId);
+
+    if (startNode == -1 || endNode == -1) {
+        printf("Start or end node not found.\n");
+        return result;
+    }
+
+    SearchMode m = {startNode, endNode, 0, 0, -1};
+    PathStatus status = PATH_OK;
+    ov->ioError = 0;
+    result.settledNodes = runOverlaySearch(g, ov, &m, limits, &status);
+
+    if (status != PATH_OK) {
+        result.status = status;
+        if (status == PATH_IO_ERROR) return result;
+        if (limits->fallback == FALLBACK_STRAIGHT_LINE) {
+            result.distance = straightLine(g, startNode, endNode);
+            result.estimate = FALLBACK_STRAIGHT_LINE;
+        }
+        else if (limits->fallback == FALLBACK_PARTIAL) {
+            if (overlayPartialEstimate(g, ov, startNode, endNode, &result)) {
+                result.estimate = FALLBACK_PARTIAL;
+            }
+            else {
+                result.status = PATH_IO_ERROR;
+                result.distance = -1;
+            }
+        }
+        return result;
+    }
+
+    double d = searchDist(&ov->search, endNode);
+    if (d == DBL_MAX) return result;
+
+    // put preko overlay-a, pa raspakivanje precica u ivice grafa
+    if (buildOverlayPath(g, ov, startNode, endNode, &result)) {
+        result.status = PATH_OK;
+        result.distance = d;
+    }
+    else {
+        // raspakivanje nije uspjelo: duzina bez putanje nije pouzdan rezultat
+        result.status = PATH_IO_ERROR;
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Izgradnja, cuvanje i ucitavanje
+
+static Overlay* allocOverlay(int numNodes, size_t cacheBytes) {
+    Overlay *ov = (Overlay*) calloc(1, sizeof(Overlay));
+    ov->numNodes = numNodes;
+    ov->cellCode = (uint32_t*) calloc(numNodes + 1, sizeof(uint32_t));
+    ov->lruHead = ov->lruTail = ov->freeEntry = -1;
+    ov->cacheBytes = cacheBytes > 0 ? cacheBytes : OVERLAY_DEFAULT_CACHE_BYTES;
+
+    OverlaySearch *s = &ov->search;
+    s->dist = (double*) malloc((numNodes + 1) * sizeof(double));
+    s->parent = (int*) malloc((numNodes + 1) * sizeof(int));
+    s->parentEdge = (int*) malloc((numNodes + 1) * sizeof(int));
+    s->arcLevel = (unsigned char*) malloc(numNodes + 1);
+    s->stamp = (int*) calloc(numNodes + 1, sizeof(int));
+    s->settledStamp = (int*) calloc(numNodes + 1, sizeof(int));
+    s->heap = (int*) malloc((numNodes + 1) * sizeof(int));
+    s->heapPos = (int*) malloc((numNodes + 1) * sizeof(int));
+    return ov;
+}
+
+static void allocCacheSlots(Overlay *ov) {
+    for (int l = 1; l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        int numBoundary = lv->boundaryStart[lv->numCells];
+        lv->rowSlot = (int*) malloc((numBoundary + 1) * sizeof(int));
+        for (int k = 0; k < numBoundary; k++) lv->rowSlot[k] = -1;
+    }
+}
+
+// matrica celije: pretraga od svakog granicnog cvora unutar celije, na nivou ispod
+static int writeClique(Graph *g, Overlay *ov, int level, uint32_t cell) {
+    OverlayLevel *lv = &ov->levels[level];
+    int first = lv->boundaryStart[cell];
+    int b = lv->boundaryStart[cell + 1] - first;
+    lv->cliqueOffset[cell] = ov->writePos;
+    if (b == 0) return 0;
+
+    double *matrix = (double*) malloc((size_t) b * b * sizeof(double));
+    for (int i = 0; i < b; i++) {
+        SearchMode m = {lv->boundary[first + i], -1, level, cell, level - 1};
+        runOverlaySearch(g, ov, &m, NULL, NULL);
+        if (ov->ioError) {
+            free(matrix);
+            return -1;
+        }
+        for (int j = 0; j < b; j++) {
+            double d = searchDist(&ov->search, lv->boundary[first + j]);
+            matrix[(size_t) i * b + j] = d == DBL_MAX ? INFINITY : d;
+        }
+    }
+
+    size_t bytes = (size_t) b * b * sizeof(double);
+    int ok = seekFile(ov->fp, ov->writePos) == 0 && fwrite(matrix, 1, bytes, ov->fp) == bytes;
+    ov->writePos += bytes;
+    free(matrix);
+    return ok ? 0 : -1;
+}
+
+Overlay* buildOverlay(Graph *g, const char *filename, int levels, int cellSize, size_t cacheBytes) {
+    if (levels <= 0) levels = 3;
+    int requestedLevels = levels;
+    if (levels > OVERLAY_MAX_LEVELS) levels = OVERLAY_MAX_LEVELS;
+    if (cellSize <= 0) cellSize = OVERLAY_DEFAULT_CELL_SIZE;
+
+    FILE *fp = fopen(filename, "w+b");
+    if (!fp) {
+        fprintf(stderr, "Greska: nije moguce upisati fajl \"%s\"\n", filename);
+        return NULL;
+    }
+    setvbuf(fp, NULL, _IONBF, 0); // redovi se citaju pojedinacno: bez citanja cijelog bafera
+
+    Overlay *ov = allocOverlay(g->numNodes, cacheBytes);
+    ov->fp = fp;
+    ov->requestedLevels = requestedLevels;
+    ov->cellSize = cellSize;
+
+    // dubina bisekcije: celije najnizeg nivoa imaju najvise cellSize cvorova
+    int depth = 0;
+    while (depth < 30 && (g->numNodes >> depth) > cellSize) depth++;
+    partitionGraph(g, ov, depth);
+
+    ov->numLevels = levels < depth ? levels : depth;
+    int bitsPerLevel = ov->numLevels > 0 ? depth / ov->numLevels : 0;
+    for (int l = 1; l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        lv->shift = (l - 1) * bitsPerLevel;
+        lv->numCells = 1 << (depth - lv->shift);
+        lv->cliqueOffset = (long long*) calloc(lv->numCells, sizeof(long long));
+        computeBoundaries(g, ov, l);
+    }
+    allocCacheSlots(ov);
+
+    // zaglavlje, particija i granicni cvorovi
+    int32_t header[6] = {OVERLAY_VERSION, g->numNodes, ov->numLevels, requestedLevels, cellSize, EDGE_WEIGHT_MODE};
+    uint64_t checksum = graphChecksum(g);
+    long long indexOffset = 0; // upisuje se na kraju
+    int ok = fwrite(OVERLAY_MAGIC, 1, 4, fp) == 4 &&
+             fwrite(header, sizeof(int32_t), 6, fp) == 6 &&
+             fwrite(&checksum, sizeof(checksum), 1, fp) == 1 &&
+             fwrite(&indexOffset, sizeof(indexOffset), 1, fp) == 1 &&
+             fwrite(ov->cellCode, sizeof(uint32_t), g->numNodes, fp) == (size_t) g->numNodes;
+    for (int l = 1; ok && l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        int32_t levelHeader[2] = {lv->shift, lv->numCells};
+        int numBoundary = lv->boundaryStart[lv->numCells];
+        ok = fwrite(levelHeader, sizeof(int32_t), 2, fp) == 2 &&
+             fwrite(lv->boundaryStart, sizeof(int), lv->numCells + 1, fp) == (size_t) lv->numCells + 1 &&
+             fwrite(lv->boundary, sizeof(int), numBoundary, fp) == (size_t) numBoundary;
+    }
+    fflush(fp);
+    ov->writePos = tellFile(fp);
+
+    // matrice nivo po nivo; visi nivoi citaju matrice nizeg nivoa kroz kes
+    for (int l = 1; ok && l <= ov->numLevels; l++) {
+        for (int c = 0; ok && c < ov->levels[l].numCells; c++) {
+            ok = writeClique(g, ov, l, (uint32_t) c) == 0;
+        }
+    }
+
+    // indeks polozaja matrica
+    indexOffset = ov->writePos;
+    ok = ok && seekFile(fp, indexOffset) == 0;
+    for (int l = 1; ok && l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        ok = fwrite(lv->cliqueOffset, sizeof(long long), lv->numCells, fp) == (size_t) lv->numCells;
+    }
+    ok = ok && seekFile(fp, INDEX_OFFSET_POS) == 0 &&
+         fwrite(&indexOffset, sizeof(indexOffset), 1, fp) == 1 && fflush(fp) == 0;
+
+    if (!ok) {
+        fprintf(stderr, "Greska: upis overlay-a u \"%s\" nije uspio\n", filename);
+        freeOverlay(ov);
+        remove(filename);
+        return NULL;
+    }
+    return ov;
+}
+
+// sadrzaj ucitanog fajla mora biti konzistentan prije nego sto ga pretraga indeksira:
+// celije cvorova, granicni cvorovi (rastuci, u svojoj celiji) i polozaji matrica
+static int validateOverlay(Overlay *ov, long long indexOffset) {
+    long long dataStart = INDEX_OFFSET_POS + sizeof(long long) + (long long) ov->numNodes * sizeof(uint32_t);
+    for (int l = 1; l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        for (int v = 0; v < ov->numNodes; v++) {
+            if (cellOf(ov, l, v) >= (uint32_t) lv->numCells) return 0;
+        }
+        if (lv->boundaryStart[0] != 0) return 0;
+        for (int c = 0; c < lv->numCells; c++) {
+            int first = lv->boundaryStart[c], last = lv->boundaryStart[c + 1];
+            if (last < first) return 0;
+            for (int k = first; k < last; k++) {
+                int v = lv->boundary[k];
+                if (v < 0 || v >= ov->numNodes || cellOf(ov, l, v) != (uint32_t) c) return 0;
+                if (k > first && v <= lv->boundary[k - 1]) return 0;
+            }
+            long long b = last - first;
+            long long offset = lv->cliqueOffset[c];
+            if (offset < dataStart || offset + b * b * (long long) sizeof(double) > indexOffset) return 0;
+        }
+    }
+    return 1;
+}
+
+Overlay* loadOverlay(Graph *g, const char *filename, size_t cacheBytes) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return NULL;
+    setvbuf(fp, NULL, _IONBF, 0);
+
+    // zaglavlje: verzija, broj cvorova, broj nivoa (stvarni i trazeni), velicina celije, tip tezine
+    char magic[4];
+    int32_t header[6];
+    uint64_t checksum;
+    long long indexOffset;
+    if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, OVERLAY_MAGIC, 4) != 0 ||
+        fread(header, sizeof(int32_t), 6, fp) != 6 ||
+        fread(&checksum, sizeof(checksum), 1, fp) != 1 ||
+        fread(&indexOffset, sizeof(indexOffset), 1, fp) != 1 ||
+        header[0] != OVERLAY_VERSION || header[1] != g->numNodes ||
+        header[2] < 0 || header[2] > OVERLAY_MAX_LEVELS || header[2] > header[3] || header[4] <= 0 ||
+        header[5] != EDGE_WEIGHT_MODE || indexOffset <= 0 || checksum != graphChecksum(g)) {
+        fclose(fp);
+        return NULL;
+    }
+
+    Overlay *ov = allocOverlay(g->numNodes, cacheBytes);
+    ov->fp = fp;
+    ov->numLevels = header[2];
+    ov->requestedLevels = header[3];
+    ov->cellSize = header[4];
+
+    int ok = fread(ov->cellCode, sizeof(uint32_t), g->numNodes, fp) == (size_t) g->numNodes;
+    for (int l = 1; ok && l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        int32_t levelHeader[2];
+        ok = fread(levelHeader, sizeof(int32_t), 2, fp) == 2 &&
+             levelHeader[0] >= 0 && levelHeader[0] < 32 && levelHeader[1] > 0 &&
+             levelHeader[1] <= (1 << 30) && levelHeader[1] <= 2 * (long long) g->numNodes + 1;
+        if (!ok) break;
+
+        lv->shift = levelHeader[0];
+        lv->numCells = levelHeader[1];
+        lv->boundaryStart = (int*) malloc((lv->numCells + 1) * sizeof(int));
+        ok = fread(lv->boundaryStart, sizeof(int), lv->numCells + 1, fp) == (size_t) lv->numCells + 1;
+        int numBoundary = ok ? lv->boundaryStart[lv->numCells] : 0;
+        ok = ok && numBoundary >= 0 && numBoundary <= g->numNodes;
+        if (!ok) break;
+
+        lv->boundary = (int*) malloc((numBoundary + 1) * sizeof(int));
+        lv->cliqueOffset = (long long*) malloc(lv->numCells * sizeof(long long));
+        ok = fread(lv->boundary, sizeof(int), numBoundary, fp) == (size_t) numBoundary;
+    }
+
+    ok = ok && seekFile(fp, indexOffset) == 0;
+    for (int l = 1; ok && l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        ok = fread(lv->cliqueOffset, sizeof(long long), lv->numCells, fp) == (size_t) lv->numCells;
+    }
+    ok = ok && validateOverlay(ov, indexOffset);
+
+    if (!ok) {
+        freeOverlay(ov);
+        return NULL;
+    }
+    allocCacheSlots(ov);
+    return ov;
+}
+
+void freeOverlay(Overlay *ov) {
+    if (!ov) return;
+    if (ov->fp) fclose(ov->fp);
+    for (int l = 1; l <= ov->numLevels; l++) {
+        OverlayLevel *lv = &ov->levels[l];
+        free(lv->boundaryStart);
+        free(lv->boundary);
+        free(lv->cliqueOffset);
+        free(lv->rowSlot);
+    }
+    for (int i = 0; i < ov->numEntries; i++) free(ov->entries[i].row);
+    free(ov->entries);
+    free(ov->cellCode);
+    free(ov->search.dist);
+    free(ov->search.parent);
+    free(ov->search.parentEdge);
+    free(ov->search.arcLevel);
+    free(ov->search.stamp);
+    free(ov->search.settledStamp);
+    free(ov->search.heap);
+    free(ov->search.heapPos);
+    free(ov);
+}
@@ -0,0 +1,94 @@
+#ifndef OVERLAY_H
+#define OVERLAY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "../model/graph.h"
+#include "pathfinder.h"
+
+// Visenivovsko rutiranje preko particija ("cell overlay", po uzoru na CRP).
+// Graf se rekurzivnom bisekcijom po koordinatama (bira se rez sa najmanje ivica)
+// dijeli na celije; celije nivoa l+1 su unije celija nivoa l. Granicni cvorovi
+// celije su krajevi ivica koje je napustaju, a za svaku celiju se racuna matrica
+// ("klika") udaljenosti izmedju njenih granicnih cvorova unutar celije.
+// Upit je Dijkstra koja u celijama starta i cilja koristi ivice grafa, a dalje
+// samo klike i rezne ivice najviseg nivoa na kome se celija razlikuje od obje.
+// Matrice su u fajlu, a po potrebi se ucitavaju red po red (red = jedan granicni
+// cvor) u ograniceni kes (LRU).
+
+#define OVERLAY_MAX_LEVELS 8
+#define OVERLAY_DEFAULT_CELL_SIZE 256                 // cvorova po celiji najnizeg nivoa
+#define OVERLAY_DEFAULT_CACHE_BYTES (64u * 1024 * 1024)
+
+typedef struct OverlayLevel {
+    int shift;               // celija cvora v na ovom nivou: cellCode[v] >> shift
+    int numCells;
+    int *boundaryStart;      // granicni cvorovi celije c: boundary[boundaryStart[c] .. boundaryStart[c + 1])
+    int *boundary;           // indeksi cvorova, rastuce unutar celije
+    long long *cliqueOffset; // polozaj matrice celije u fajlu (redovi jedan za drugim)
+    int *rowSlot;            // ucitan red za granicni cvor boundary[k] (indeks u kesu) ili -1
+} OverlayLevel;
+
+// ucitan red matrice; lista po vremenu koriscenja (LRU)
+typedef struct CliqueEntry {
+    int level;
+    int boundaryPos;  // polozaj granicnog cvora u levels[level].boundary
+    double *row;      // row[j] = d(boundary[i], boundary[j]) unutar celije, INFINITY ako nema puta
+    size_t bytes;
+    int prev, next;
+} CliqueEntry;
+
+// prostor pretrage sa lijenom inicijalizacijom (vrijednost vazi samo uz tekuci pecat)
+typedef struct OverlaySearch {
+    double *dist;
+    int *parent;
+    int *parentEdge;         // ivica grafa kojom se stiglo do cvora (-1 za luk klike)
+    unsigned char *arcLevel; // nivo luka kojim se stiglo do cvora (0 = ivica grafa)
+    int *stamp;              // dist/parent vaze ako je stamp[v] == current
+    int *settledStamp;
+    int current;
+    int *heap;               // red sa prioritetom po dist (svaki cvor najvise jednom)
+    int *heapPos;            // polozaj cvora u heap-u
+    int heapSize;
+} OverlaySearch;
+
+typedef struct Overlay {
+    int numNodes;
+    int numLevels;           // moze biti manje od trazenog ako je graf mali
+    int requestedLevels;     // broj nivoa trazen pri izgradnji (za poredjenje pri ucitavanju)
+    int cellSize;            // najvise cvorova po celiji najnizeg nivoa
+    uint32_t *cellCode;      // celija najnizeg nivoa za svaki cvor
+    OverlayLevel levels[OVERLAY_MAX_LEVELS + 1]; // koriste se levels[1 .. numLevels]
+
+    FILE *fp;                // fajl sa matricama (ostaje otvoren)
+    long long writePos;      // kraj fajla tokom izgradnje
+
+    CliqueEntry *entries;
+    int numEntries;
+    int entryCapacity;
+    int lruHead, lruTail;    // najskorije / najdavnije koriscena matrica
+    int freeEntry;           // lista slobodnih unosa (preko next)
+    size_t cacheBytes;       // granica memorije za matrice
+    size_t usedBytes;
+    long cacheHits, cacheMisses;
+    int ioError;             // citanje matrice nije uspjelo (pretraga se prekida)
+
+    OverlaySearch search;
+} Overlay;
+
+// Particionise graf, racuna matrice svih nivoa i upisuje ih u filename.
+// levels <= 0 i cellSize <= 0 biraju podrazumijevane vrijednosti.
+Overlay* buildOverlay(Graph *g, const char *filename, int levels, int cellSize, size_t cacheBytes);
+
+// Otvara sacuvan overlay; NULL ako fajl ne postoji ili ne odgovara grafu
+Overlay* loadOverlay(Graph *g, const char *filename, size_t cacheBytes);
+
+// Najkraci put preko overlay-a; limits moze biti NULL. Nakon prekida se procjena
+// bira po limits->fallback (djelimicna putanja se raspakuje do obradjenog cvora najblizeg cilju).
+// Ako citanje matrice ne uspije, status je PATH_IO_ERROR.
+PathResult findShortestPathOverlay(Graph *g, Overlay *ov, long long startNodeId, long long endNodeId,
+                                   const SearchLimits *limits);
+
+void freeOverlay(Overlay *ov);
+
+#endif
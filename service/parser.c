@@ -1,4 +1,5 @@
 #include "parser.h"
+#include "pbf_parser.h"
 #include "../utils/geometry.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +28,53 @@ char* getAttr(const char *line, const char *attrName) {
     return val;
 }
 
+int addWayEdges(Graph *g, const long long *refs, int refCount, const char *name) {
+    if (refCount < 2) return 0;
+
+    int *segFrom = (int*) malloc((refCount - 1) * sizeof(int));
+    double *segBuf = (double*) malloc(5 * (refCount - 1) * sizeof(double));
+    if (!segFrom || !segBuf) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za segmente puta (%d cvorova)\n", refCount);
+        free(segFrom);
+        free(segBuf);
+        return -1;
+    }
+    double *segLat1 = segBuf, *segLon1 = segBuf + (refCount - 1);
+    double *segLat2 = segBuf + 2 * (refCount - 1), *segLon2 = segBuf + 3 * (refCount - 1);
+    double *segDist = segBuf + 4 * (refCount - 1);
+
+    // skupi sve segmente puta pa izracunaj duzine odjednom (vektorski)
+    int segCount = 0;
+    for (int j = 0; j < refCount - 1; j++) {
+        int nodeU = findNodeIndex(g, refs[j]);
+        int nodeV = findNodeIndex(g, refs[j+1]);
+        
+        if (nodeU != -1 && nodeV != -1) {
+            segFrom[segCount] = j;
+            segLat1[segCount] = nodeLat(g, nodeU);
+            segLon1[segCount] = nodeLon(g, nodeU);
+            segLat2[segCount] = nodeLat(g, nodeV);
+            segLon2[segCount] = nodeLon(g, nodeV);
+            segCount++;
+        }
+    }
+    calculateDistanceBatch(segLat1, segLon1, segLat2, segLon2, segDist, segCount);
+    
+    int result = 0;
+    for (int j = 0; j < segCount && result == 0; j++) {
+        long long u = refs[segFrom[j]];
+        long long v = refs[segFrom[j] + 1];
+        if (addEdge(g, u, v, segDist[j], name) != 0 ||
+            addEdge(g, v, u, segDist[j], name) != 0) { // Neusmjereno
+            result = -1;
+        }
+    }
+
+    free(segFrom);
+    free(segBuf);
+    return result;
+}
+
 int parseMap(const char *filename, Graph *g) {
     FILE *fp = fopen(filename, "r");
     if (!fp) {
@@ -37,12 +85,12 @@ int parseMap(const char *filename, Graph *g) {
     char line[1024];
     int inWay = 0;
     int inNode = 0;
-    long currentWayId = -1;
-    long currentNodeId = -1;
+    long long currentWayId = -1;
+    long long currentNodeId = -1;
     double currentLat = 0, currentLon = 0;
     char *currentNodeName = NULL;
     
-    long *nodeRefs = (long*) malloc(50000 * sizeof(long));
+    long long *nodeRefs = (long long*) malloc(50000 * sizeof(long long));
     if (!nodeRefs) {
         fprintf(stderr, "Greska: nema dovoljno memorije za nodeRefs\n");
         fclose(fp);
@@ -59,7 +107,8 @@ int parseMap(const char *filename, Graph *g) {
     fflush(stdout);
     
     long lineCount = 0;
-    while (fgets(line, sizeof(line), fp)) {
+    int result = 0;
+    while (result == 0 && fgets(line, sizeof(line), fp)) {
         lineCount++;
         // pocetak cvora
         if (strstr(line, "<node")) {
@@ -68,7 +117,7 @@ int parseMap(const char *filename, Graph *g) {
             char *lonStr = getAttr(line, "lon");
             
             if (idStr && latStr && lonStr) {
-                currentNodeId = atol(idStr);
+                currentNodeId = atoll(idStr);
                 currentLat = atof(latStr);
                 currentLon = atof(lonStr);
                 inNode = 1;
@@ -76,7 +125,7 @@ int parseMap(const char *filename, Graph *g) {
                 
                 // provjera da li je samozatvarajuci
                 if (strstr(line, "/>")) {
-                    addNode(g, currentNodeId, currentLat, currentLon, NULL);
+                    if (addNode(g, currentNodeId, currentLat, currentLon, NULL) != 0) result = -1;
                     inNode = 0;
                 }
             }
@@ -87,7 +136,7 @@ int parseMap(const char *filename, Graph *g) {
         }
         // kraj cvora
         else if (inNode && strstr(line, "</node>")) {
-            addNode(g, currentNodeId, currentLat, currentLon, currentNodeName);
+            if (addNode(g, currentNodeId, currentLat, currentLon, currentNodeName) != 0) result = -1;
             if (currentNodeName) { free(currentNodeName); currentNodeName = NULL; }
             inNode = 0;
         }
@@ -100,26 +149,14 @@ int parseMap(const char *filename, Graph *g) {
             
             char *idStr = getAttr(line, "id");
             if (idStr) {
-                currentWayId = atol(idStr);
+                currentWayId = atoll(idStr);
                 free(idStr);
             }
         }
         // kraj puta (way)
         else if (inWay && strstr(line, "</way>")) {
-            if (isHighway && refCount > 1) {
-                for (int j = 0; j < refCount - 1; j++) {
-                    long u = nodeRefs[j];
-                    long v = nodeRefs[j+1];
-                    
-                    Node *nodeU = findNode(g, u);
-                    Node *nodeV = findNode(g, v);
-                    
-                    if (nodeU && nodeV) {
-                        double dist = calculateDistance(nodeU->lat, nodeU->lon, nodeV->lat, nodeV->lon);
-                        addEdge(g, u, v, dist, wayName);
-                        addEdge(g, v, u, dist, wayName); // Neusmjereno
-                    }
-                }
+            if (isHighway) {
+                if (addWayEdges(g, nodeRefs, refCount, wayName) != 0) result = -1;
             }
             inWay = 0;
             if (wayName) { free(wayName); wayName = NULL; }
@@ -129,7 +166,7 @@ int parseMap(const char *filename, Graph *g) {
             char *refStr = getAttr(line, "ref");
             if (refStr) {
                 if (refCount < 50000) {
-                    nodeRefs[refCount++] = atol(refStr);
+                    nodeRefs[refCount++] = atoll(refStr);
                 }
                 free(refStr);
             }
@@ -184,7 +221,16 @@ int parseMap(const char *filename, Graph *g) {
         }
     }
 
+    free(currentNodeName);
+    free(wayName);
     free(nodeRefs);
     fclose(fp);
-    return 0;
+    return result;
+}
+
+int loadMap(const char *filename, Graph *g) {
+    if (isPbfFile(filename)) {
+        return parsePbfMap(filename, g);
+    }
+    return parseMap(filename, g);
 }
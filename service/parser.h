@@ -5,4 +5,11 @@
 
 int parseMap(const char *filename, Graph *g);
 
+// Ucitava mapu u XML (.osm) ili PBF (.osm.pbf) formatu, zavisno od sadrzaja fajla
+int loadMap(const char *filename, Graph *g);
+
+// Dodaje neusmjerene ivice izmedju uzastopnih cvorova puta (zajednicko za oba formata);
+// vraca -1 ako nema dovoljno memorije
+int addWayEdges(Graph *g, const long long *refs, int refCount, const char *name);
+
 #endif
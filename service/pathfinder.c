@@ -1,11 +1,13 @@
 #include "pathfinder.h"
+#include "../utils/geometry.h"
+#include "../utils/timer.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <float.h>
 
 // implementacija reda sa prioritetom
 typedef struct {
-    Node *node;
+    int node; // indeks cvora
     double dist;
 } PQNode;
 
@@ -46,8 +48,12 @@ void minHeapify(MinHeap *h, int idx) {
     }
 }
 
-void push(MinHeap *h, Node *node, double dist) {
-    if (h->size == h->capacity) return; // trebalo bi promijeniti velicinu
+void push(MinHeap *h, int node, double dist) {
+    if (h->size == h->capacity) {
+        // cvor moze biti u heapu vise puta, pa heap raste po potrebi
+        h->capacity *= 2;
+        h->nodes = (PQNode*) realloc(h->nodes, h->capacity * sizeof(PQNode));
+    }
 
     int i = h->size++;
     h->nodes[i].node = node;
@@ -61,7 +67,7 @@ void push(MinHeap *h, Node *node, double dist) {
 
 PQNode pop(MinHeap *h) {
     if (h->size <= 0) {
-        PQNode empty = {NULL, -1};
+        PQNode empty = {-1, -1};
         return empty;
     }
     if (h->size == 1) {
@@ -81,87 +87,276 @@ int isEmpty(MinHeap *h) {
     return h->size == 0;
 }
 
-// Dijkstrin algoritam
-PathResult findShortestPath(Graph *g, long long startNodeId, long long endNodeId) {
-    PathResult result;
-    result.distance = -1;
-    result.pathNodes = NULL;
-    result.pathLength = 0;
-
-    Node *startNode = findNode(g, startNodeId);
-    Node *endNode = findNode(g, endNodeId);
+// da li pretragu treba prekinuti (PATH_OK = nastavi)
+PathStatus checkSearchLimits(const SearchLimits *limits, int settled) {
+    if (limits->cancel && *limits->cancel) return PATH_CANCELLED;
+    if (limits->maxSettled > 0 && settled >= limits->maxSettled) return PATH_TIMEOUT;
+    if (limits->deadlineMs > 0 && nowMs() >= limits->deadlineMs) return PATH_TIMEOUT;
+    return PATH_OK;
+}
 
-    if (!startNode || !endNode) {
-        printf("Start or end node not found.\n");
-        return result;
-    }
-    
+// Dijkstrin algoritam (A* ako je data heuristika).
+// Rezultat ostaje u g->dist i g->parent; end = -1 racuna stablo do svih cvorova.
+// Ako je pretraga prekinuta zbog ogranicenja, *status dobija razlog.
+static int runSearch(Graph *g, int startNode, int endNode, Heuristic heuristic, void *ctx,
+                     const SearchLimits *limits, PathStatus *status) {
     // Inicijalizuj
-    Node *curr = g->nodes;
-    while (curr != NULL) {
-        curr->dist = DBL_MAX;
-        curr->visited = 0;
-        curr->parent = NULL;
-        curr = curr->nextGlobal;
+    double *dist = g->dist;
+    unsigned char *visited = g->visited;
+    int *parent = g->parent;
+    int *parentEdge = g->parentEdge;
+    for (int i = 0; i < g->numNodes; i++) {
+        dist[i] = DBL_MAX;
+        visited[i] = 0;
+        parent[i] = -1;
+        parentEdge[i] = -1;
     }
 
+    dist[startNode] = 0;
+    int settled = 0;
     
-    startNode->dist = 0;
-    
-    MinHeap *pq = createMinHeap(g->numNodes + 100); // sigurna velicina
-    push(pq, startNode, 0);
+    MinHeap *pq = createMinHeap(g->numNodes + 100); // pocetna velicina
+    push(pq, startNode, heuristic ? heuristic(g, startNode, endNode, ctx) : 0);
     
     while (!isEmpty(pq)) {
         PQNode minNode = pop(pq);
-        Node *u = minNode.node;
+        int u = minNode.node;
         
-        if (u->visited) continue;
-        u->visited = 1;
+        if (visited[u]) continue;
+        visited[u] = 1;
+        settled++;
         
         if (u == endNode) break;
+
+        // jeftina provjera: sat se cita samo povremeno, a budzet se postuje tacno
+        if (limits && (settled % SEARCH_CHECK_INTERVAL == 0 || settled == limits->maxSettled)) {
+            PathStatus stop = checkSearchLimits(limits, settled);
+            if (stop != PATH_OK) {
+                if (status) *status = stop;
+                break;
+            }
+        }
         
-        Edge *e = u->edges;
-        while (e != NULL) {
-            Node *v = findNode(g, e->targetNodeId);
-            if (v && !v->visited) {
-                double newDist = u->dist + e->weight;
-                if (newDist < v->dist) { // azuriranje komsije
-                    v->dist = newDist;
-                    v->parent = u;
-                    push(pq, v, newDist);
-                }
+        for (int k = g->firstEdge[u]; k != -1; k = g->edges[k].next) {
+            Edge *e = &g->edges[k];
+            int v = e->target;
+            double newDist = dist[u] + edgeWeight(e);
+            // kod Dijkstre posjeceni cvor se ne moze poboljsati; kod A* sa
+            // heuristikom koja nije potpuno konzistentna cvor se ponovo otvara
+            if (newDist < dist[v]) { // azuriranje komsije
+                dist[v] = newDist;
+                parent[v] = u;
+                parentEdge[v] = k;
+                visited[v] = 0;
+                push(pq, v, heuristic ? newDist + heuristic(g, v, endNode, ctx) : newDist);
+            }
+            else if (newDist == dist[v] && dist[u] < newDist && u < parent[v]) {
+                parent[v] = u; // jednoznacan roditelj kod jednakih duzina (isto kao delta-stepping)
+                parentEdge[v] = k;
             }
-            e = e->next;
         }
     }
     
     free(pq->nodes);
     free(pq);
+    return settled;
+}
+
+// putanja od starta do cvora node po g->parent (sa ivicama iz g->parentEdge)
+static void buildPath(Graph *g, int node, PathResult *result) {
+    int count = 0;
+    int curr = node;
+    while (curr != -1) {
+        count++;
+        curr = g->parent[curr];
+    }
     
-    if (endNode->dist != DBL_MAX) {
-        result.distance = endNode->dist;
-        
-        // Rekonstruisi putanju
-        int count = 0;
-        curr = endNode;
-        while (curr != NULL) {
-            count++;
-            curr = curr->parent;
-        }
-        
-        result.pathLength = count;
-        result.pathNodes = (long long*) malloc(count * sizeof(long long));
-        
-        curr = endNode;
-        for (int i = count - 1; i >= 0; i--) {
-            result.pathNodes[i] = curr->id;
-            curr = curr->parent;
+    result->pathLength = count;
+    result->pathNodes = (long long*) malloc(count * sizeof(long long));
+    result->pathEdges = (int*) malloc(count * sizeof(int));
+    
+    curr = node;
+    for (int i = count - 1; i >= 0; i--) {
+        result->pathNodes[i] = g->nodes[curr].id;
+        result->pathEdges[i] = g->parentEdge[curr];
+        curr = g->parent[curr];
+    }
+}
+
+static double straightLine(Graph *g, int a, int b) {
+    return calculateDistance(nodeLat(g, a), nodeLon(g, a), nodeLat(g, b), nodeLon(g, b));
+}
+
+// procjena nakon prekida: obradjeni cvor najblizi cilju (vazdusnom linijom),
+// duzina = stvarna udaljenost do njega + vazdusna linija do cilja.
+// Haversinus se racuna samo za obradjene cvorove (koliko je pretraga stigla prije
+// roka); ostalo je jedan prolaz kroz visited, iste cijene kao inicijalizacija pretrage.
+static void partialEstimate(Graph *g, int startNode, int endNode, PathResult *result) {
+    int best = startNode;
+    double bestRest = straightLine(g, startNode, endNode);
+    for (int v = 0; v < g->numNodes; v++) {
+        if (!g->visited[v]) continue;
+        double rest = straightLine(g, v, endNode);
+        if (rest < bestRest || (rest == bestRest && g->dist[v] < g->dist[best])) {
+            bestRest = rest;
+            best = v;
         }
     }
+    result->distance = g->dist[best] + bestRest;
+    buildPath(g, best, result);
+}
+
+void applyFallback(Graph *g, int startNode, int endNode, FallbackMode fallback, PathResult *result) {
+    if (fallback == FALLBACK_STRAIGHT_LINE) {
+        result->distance = straightLine(g, startNode, endNode);
+    }
+    else if (fallback == FALLBACK_PARTIAL) {
+        partialEstimate(g, startNode, endNode, result);
+    }
+    result->estimate = fallback;
+}
+
+PathResult findShortestPathLimited(Graph *g, long long startNodeId, long long endNodeId,
+                                   Heuristic heuristic, void *ctx, const SearchLimits *limits) {
+    PathResult result;
+    result.distance = -1;
+    result.pathNodes = NULL;
+    result.pathEdges = NULL;
+    result.pathLength = 0;
+    result.settledNodes = 0;
+    result.status = PATH_NOT_FOUND;
+    result.estimate = FALLBACK_NONE;
+
+    int startNode = findNodeIndex(g, startNodeId);
+    int endNode = findNodeIndex(g, endNodeId);
+
+    if (startNode == -1 || endNode == -1) {
+        printf("Start or end node not found.\n");
+        return result;
+    }
+
+    PathStatus status = PATH_OK;
+    result.settledNodes = runSearch(g, startNode, endNode, heuristic, ctx, limits, &status);
+
+    if (status != PATH_OK) {
+        result.status = status;
+        applyFallback(g, startNode, endNode, limits->fallback, &result);
+        return result;
+    }
+    
+    if (g->dist[endNode] != DBL_MAX) {
+        result.status = PATH_OK;
+        result.distance = g->dist[endNode];
+        buildPath(g, endNode, &result); // Rekonstruisi putanju
+    }
     
     return result;
 }
 
+PathResult findShortestPathHeuristic(Graph *g, long long startNodeId, long long endNodeId,
+                                     Heuristic heuristic, void *ctx) {
+    return findShortestPathLimited(g, startNodeId, endNodeId, heuristic, ctx, NULL);
+}
+
+PathResult findShortestPath(Graph *g, long long startNodeId, long long endNodeId) {
+    return findShortestPathHeuristic(g, startNodeId, endNodeId, NULL, NULL);
+}
+
+void computeShortestPathTree(Graph *g, int source) {
+    runSearch(g, source, -1, NULL, NULL, NULL, NULL);
+}
+
+// vrh reda bez vec obradjenih cvorova (DBL_MAX ako je red prazan)
+static double topKey(MinHeap *pq, const unsigned char *visited) {
+    while (!isEmpty(pq) && visited[pq->nodes[0].node]) pop(pq);
+    return isEmpty(pq) ? DBL_MAX : pq->nodes[0].dist;
+}
+
+int computeBidirectionalTrees(Graph *g, ReverseAdjacency *rev, int source, int target, double stretch,
+                              const SearchLimits *limits, PathStatus *status, int *meet) {
+    // strana 0: od izvora po g, strana 1: od cilja po obrnutim ivicama
+    double *dist[2] = {g->dist, rev->dist};
+    unsigned char *visited[2] = {g->visited, rev->visited};
+    int *parent[2] = {g->parent, rev->parent};
+    int *parentEdge[2] = {g->parentEdge, rev->parentEdge};
+    int *firstEdge[2] = {g->firstEdge, rev->firstEdge};
+    Edge *edges[2] = {g->edges, rev->edges};
+    for (int side = 0; side < 2; side++) {
+        for (int i = 0; i < g->numNodes; i++) {
+            dist[side][i] = DBL_MAX;
+            visited[side][i] = 0;
+            parent[side][i] = -1;
+            parentEdge[side][i] = -1;
+        }
+    }
+
+    MinHeap *pq[2] = {createMinHeap(g->numNodes + 100), createMinHeap(g->numNodes + 100)};
+    dist[0][source] = 0;
+    dist[1][target] = 0;
+    push(pq[0], source, 0);
+    push(pq[1], target, 0);
+
+    double mu = source == target ? 0 : DBL_MAX; // najkraci do sada spojen put
+    int best = source == target ? source : -1;
+    double bound = DBL_MAX;                     // stretch * d, kad je d poznato
+    int settled = 0;
+    *meet = -1;
+
+    while (1) {
+        double top[2] = {topKey(pq[0], visited[0]), topKey(pq[1], visited[1])};
+        if (bound == DBL_MAX) {
+            if (mu == DBL_MAX && (top[0] == DBL_MAX || top[1] == DBL_MAX)) break; // cilj nedostizan
+            if (top[0] == DBL_MAX || top[1] == DBL_MAX || top[0] + top[1] >= mu) {
+                bound = mu * stretch; // d = mu je konacno
+                *meet = best;
+            }
+        }
+        int side = top[0] <= top[1] ? 0 : 1;
+        if (top[side] > bound) break;
+
+        int u = pop(pq[side]).node;
+        visited[side][u] = 1;
+        settled++;
+
+        // jedan budzet za obje strane
+        if (limits && (settled % SEARCH_CHECK_INTERVAL == 0 || settled == limits->maxSettled)) {
+            PathStatus stop = checkSearchLimits(limits, settled);
+            if (stop != PATH_OK) {
+                if (status) *status = stop;
+                break;
+            }
+        }
+
+        double *d = dist[side], *other = dist[1 - side];
+        for (int k = firstEdge[side][u]; k != -1; k = edges[side][k].next) {
+            Edge *e = &edges[side][k];
+            int v = e->target;
+            double newDist = d[u] + edgeWeight(e);
+            if (newDist < d[v]) {
+                d[v] = newDist;
+                parent[side][v] = u;
+                parentEdge[side][v] = k;
+                push(pq[side], v, newDist);
+            }
+            else if (newDist == d[v] && d[u] < newDist && u < parent[side][v]) {
+                parent[side][v] = u; // isto pravilo za jednake duzine kao runSearch
+                parentEdge[side][v] = k;
+            }
+            if (other[v] != DBL_MAX && d[v] + other[v] < mu) {
+                mu = d[v] + other[v];
+                best = v;
+            }
+        }
+    }
+
+    for (int side = 0; side < 2; side++) {
+        free(pq[side]->nodes);
+        free(pq[side]);
+    }
+    return settled;
+}
+
 void freePathResult(PathResult result) {
     if (result.pathNodes) free(result.pathNodes);
+    if (result.pathEdges) free(result.pathEdges);
 }
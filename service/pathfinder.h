@@ -1,16 +1,77 @@
 #ifndef PATHFINDER_H
 #define PATHFINDER_H
 
+#include <signal.h>
 #include "../model/graph.h"
 
+typedef enum PathStatus {
+    PATH_OK,        // najkraci put pronadjen
+    PATH_NOT_FOUND, // cilj nedostizan (ili cvor ne postoji)
+    PATH_TIMEOUT,   // istekao rok ili budzet obradjenih cvorova
+    PATH_CANCELLED, // pretraga otkazana spolja
+    PATH_IO_ERROR   // greska pri citanju sacuvanih podataka (npr. overlay matrica)
+} PathStatus;
+
+// Sta se vraca kad je pretraga prekinuta
+typedef enum FallbackMode {
+    FALLBACK_NONE,          // samo status
+    FALLBACK_STRAIGHT_LINE, // procjena: vazdusna linija od starta do cilja
+    FALLBACK_PARTIAL        // put kroz istrazeno stablo do cvora najblizeg cilju + vazdusna linija od njega
+} FallbackMode;
+
+// Ogranicenja pretrage; rok i otkazivanje se provjeravaju na svakih SEARCH_CHECK_INTERVAL obradjenih cvorova
+typedef struct SearchLimits {
+    double deadlineMs;             // apsolutni rok po nowMs(); 0 = bez roka
+    int maxSettled;                // najvise obradjenih cvorova; 0 = bez ogranicenja
+    volatile sig_atomic_t *cancel; // != 0 prekida pretragu (npr. iz signala ili druge niti); moze NULL
+    FallbackMode fallback;
+} SearchLimits;
+
+#define SEARCH_CHECK_INTERVAL 1024
+
+// Da li pretragu treba prekinuti nakon settled obradjenih cvorova (PATH_OK = nastavi)
+PathStatus checkSearchLimits(const SearchLimits *limits, int settled);
+
 typedef struct PathResult {
     double distance;
     long long *pathNodes; // niz ID-eva cvorova u putanji
+    int *pathEdges;       // pathEdges[i] = indeks ivice kojom se stiglo u pathNodes[i] (-1 za prvi)
     int pathLength;
+    int settledNodes;     // broj obradjenih cvorova (mjera cijene pretrage)
+    PathStatus status;
+    FallbackMode estimate; // FALLBACK_NONE: tacan rezultat; inace vrsta procjene nakon prekida
+                           // (putanja tada ne stize do cilja, a kod vazdusne linije je prazna)
 } PathResult;
 
+// Donja granica udaljenosti od cvora node do cilja target (indeksi cvorova)
+typedef double (*Heuristic)(Graph *g, int node, int target, void *ctx);
+
 PathResult findShortestPath(Graph *g, long long startNodeId, long long endNodeId);
 
+// A* pretraga sa datom heuristikom (NULL daje obicnu Dijkstru)
+PathResult findShortestPathHeuristic(Graph *g, long long startNodeId, long long endNodeId,
+                                     Heuristic heuristic, void *ctx);
+
+// Isto, uz rok, budzet i otkazivanje (limits moze biti NULL)
+PathResult findShortestPathLimited(Graph *g, long long startNodeId, long long endNodeId,
+                                   Heuristic heuristic, void *ctx, const SearchLimits *limits);
+
+// Procjena nakon prekinute pretrage od startNode (stablo u g->dist, g->parent, g->visited):
+// upisuje distance, putanju (FALLBACK_PARTIAL) i result->estimate
+void applyFallback(Graph *g, int startNode, int endNode, FallbackMode fallback, PathResult *result);
+
+// Dijkstra od izvora (indeks) do svih cvorova; rezultat ostaje u g->dist, g->parent i g->parentEdge
+void computeShortestPathTree(Graph *g, int source);
+
+// Dvosmjerna Dijkstra: od izvora po g i od cilja po obrnutim ivicama, uvijek strana
+// sa manjim kljucem. Kad se odredi d = d(izvor, cilj), obje strane se nastavljaju dok
+// kljuc ne predje stretch * d, pa su svi cvorovi do te granice konacni u g->dist i
+// rev->dist (stabla u parent/parentEdge). limits vazi za zbir obje strane.
+// *meet je cvor na najkracem putu kad je d odredjeno, inace -1.
+// Vraca broj obradjenih cvorova (limits i status mogu biti NULL).
+int computeBidirectionalTrees(Graph *g, ReverseAdjacency *rev, int source, int target, double stretch,
+                              const SearchLimits *limits, PathStatus *status, int *meet);
+
 void freePathResult(PathResult result);
 
 #endif
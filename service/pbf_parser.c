@@ -0,0 +1,617 @@
+#include "pbf_parser.h"
+#include "parser.h"
+#include "../utils/inflate.h"
+#include "../utils/cpu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+// OSM PBF format: niz blokova [duzina zaglavlja (4 bajta, big endian)][BlobHeader][Blob].
+// Blob sadrzi (obicno zlib kompresovan) PrimitiveBlock sa tabelom stringova i grupama
+// cvorova (DenseNodes sa delta kodiranjem) i puteva. Sve poruke su protobuf.
+
+#define MAX_HEADER_SIZE (64 * 1024)
+#define MAX_BLOB_SIZE (32 * 1024 * 1024)
+
+// blokovi se citaju i dekoduju u grupama, pa je u memoriji samo jedna grupa
+// (a ne cijeli fajl); grupa je ogranicena brojem blokova i sirovim bajtovima
+#define PBF_BATCH_BLOCKS_PER_THREAD 4
+#define PBF_BATCH_BYTES (64 * 1024 * 1024)
+
+// bafer za citanje protobuf poruke
+typedef struct {
+    const unsigned char *pos;
+    const unsigned char *end;
+    int error;
+} PbfBuf;
+
+typedef struct {
+    int field;
+    int wire;
+    uint64_t value;  // za varint polja
+    PbfBuf data;     // za polja sa duzinom (poruke, stringovi, packed nizovi)
+} PbfField;
+
+// rezultat dekodiranja jednog bloka
+typedef struct {
+    unsigned char *raw; // sirovi Blob, oslobadja se nakon dekodiranja
+    size_t rawLen;
+
+    int numNodes, capNodes;
+    long long *nodeIds;
+    double *nodeLat, *nodeLon;
+    char **nodeNames;
+
+    int numWays, capWays;
+    int *wayRefStart; // pocetak referenci puta u refs (numWays + 1 elemenata)
+    char **wayNames;
+    long long *refs;
+    int numRefs, capRefs;
+
+    int error;
+} PbfBlock;
+
+typedef struct {
+    PbfBlock *blocks;
+    int numBlocks;
+    int nextBlock;
+    pthread_mutex_t lock;
+} PbfWork;
+
+static uint64_t readVarint(PbfBuf *b) {
+    uint64_t val = 0;
+    int shift = 0;
+    while (b->pos < b->end && shift < 64) {
+        unsigned char c = *b->pos++;
+        val |= (uint64_t) (c & 0x7f) << shift;
+        if (!(c & 0x80)) return val;
+        shift += 7;
+    }
+    b->error = 1;
+    return 0;
+}
+
+static int64_t zigzag(uint64_t v) {
+    return (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+}
+
+// cita sljedece polje poruke; vraca 0 na kraju poruke ili greski
+static int nextField(PbfBuf *b, PbfField *f) {
+    if (b->error || b->pos >= b->end) return 0;
+
+    uint64_t key = readVarint(b);
+    f->field = (int) (key >> 3);
+    f->wire = (int) (key & 7);
+
+    switch (f->wire) {
+        case 0:
+            f->value = readVarint(b);
+            break;
+        case 1:
+            if (b->end - b->pos < 8) b->error = 1;
+            else b->pos += 8;
+            break;
+        case 2: {
+            uint64_t len = readVarint(b);
+            if (len > (uint64_t) (b->end - b->pos)) {
+                b->error = 1;
+                break;
+            }
+            f->data.pos = b->pos;
+            f->data.end = b->pos + len;
+            f->data.error = 0;
+            b->pos += len;
+            break;
+        }
+        case 5:
+            if (b->end - b->pos < 4) b->error = 1;
+            else b->pos += 4;
+            break;
+        default:
+            b->error = 1;
+    }
+    return !b->error;
+}
+
+static int fieldIs(PbfField *f, const char *s) {
+    size_t len = strlen(s);
+    return (size_t) (f->data.end - f->data.pos) == len && memcmp(f->data.pos, s, len) == 0;
+}
+
+static void* growArray(void *arr, int *cap, int need, size_t elemSize) {
+    if (need <= *cap) return arr;
+    int newCap = *cap ? *cap : 1024;
+    while (newCap < need) newCap *= 2;
+    *cap = newCap;
+    return realloc(arr, (size_t) newCap * elemSize);
+}
+
+// isto spajanje imena kao u XML parseru: "ime / drugo ime"
+static char* mergeName(char *current, const char *v) {
+    if (current == NULL) return strdup(v);
+    if (strstr(current, v)) return current;
+
+    size_t newLen = strlen(current) + strlen(v) + 4;
+    char *newName = (char*) malloc(newLen);
+    sprintf(newName, "%s / %s", current, v);
+    free(current);
+    return newName;
+}
+
+static int isNameKey(const char *k) {
+    return strcmp(k, "name") == 0 || strcmp(k, "name:sr-Latn") == 0 || strcmp(k, "int_name") == 0;
+}
+
+// dekompresuje Blob poruku; vraca novoalocirani bafer ili NULL
+static unsigned char* decodeBlob(const unsigned char *raw, size_t rawLen, size_t *outLen) {
+    PbfBuf b = {raw, raw + rawLen, 0};
+    PbfField f;
+    PbfBuf rawData = {NULL, NULL, 0}, zlibData = {NULL, NULL, 0};
+    uint64_t rawSize = 0;
+    int unsupported = 0;
+
+    while (nextField(&b, &f)) {
+        if (f.field == 1 && f.wire == 2) rawData = f.data;
+        else if (f.field == 2 && f.wire == 0) rawSize = f.value;
+        else if (f.field == 3 && f.wire == 2) zlibData = f.data;
+        else if (f.field >= 4 && f.wire == 2) unsupported = 1; // lzma, lz4, zstd...
+    }
+    if (b.error) return NULL;
+
+    if (rawData.pos) {
+        size_t len = rawData.end - rawData.pos;
+        unsigned char *out = (unsigned char*) malloc(len ? len : 1);
+        memcpy(out, rawData.pos, len);
+        *outLen = len;
+        return out;
+    }
+    if (zlibData.pos && rawSize <= MAX_BLOB_SIZE) {
+        unsigned char *out = (unsigned char*) malloc(rawSize ? rawSize : 1);
+        long len = inflateZlib(zlibData.pos, zlibData.end - zlibData.pos, out, rawSize);
+        if (len != (long) rawSize) {
+            free(out);
+            return NULL;
+        }
+        *outLen = (size_t) len;
+        return out;
+    }
+    if (unsupported) {
+        fprintf(stderr, "Greska: nepodrzana kompresija PBF bloka (samo zlib i raw)\n");
+    }
+    return NULL;
+}
+
+static void blockAddNode(PbfBlock *blk, long long id, double lat, double lon, char *name) {
+    int need = blk->numNodes + 1;
+    int cap = blk->capNodes;
+    blk->nodeIds = (long long*) growArray(blk->nodeIds, &cap, need, sizeof(long long));
+    cap = blk->capNodes;
+    blk->nodeLat = (double*) growArray(blk->nodeLat, &cap, need, sizeof(double));
+    cap = blk->capNodes;
+    blk->nodeLon = (double*) growArray(blk->nodeLon, &cap, need, sizeof(double));
+    cap = blk->capNodes;
+    blk->nodeNames = (char**) growArray(blk->nodeNames, &cap, need, sizeof(char*));
+    blk->capNodes = cap;
+
+    int i = blk->numNodes++;
+    blk->nodeIds[i] = id;
+    blk->nodeLat[i] = lat;
+    blk->nodeLon[i] = lon;
+    blk->nodeNames[i] = name;
+}
+
+static void decodeDenseNodes(PbfBlock *blk, PbfBuf msg, char **strings, int numStrings,
+                             long long granularity, long long latOffset, long long lonOffset) {
+    PbfField f;
+    PbfBuf ids = {NULL, NULL, 0}, lats = {NULL, NULL, 0}, lons = {NULL, NULL, 0}, kv = {NULL, NULL, 0};
+
+    while (nextField(&msg, &f)) {
+        if (f.wire != 2) continue;
+        if (f.field == 1) ids = f.data;
+        else if (f.field == 8) lats = f.data;
+        else if (f.field == 9) lons = f.data;
+        else if (f.field == 10) kv = f.data;
+    }
+    if (msg.error) {
+        blk->error = 1;
+        return;
+    }
+
+    long long id = 0, lat = 0, lon = 0;
+    while (ids.pos && ids.pos < ids.end) {
+        id += zigzag(readVarint(&ids));
+        lat += zigzag(readVarint(&lats));
+        lon += zigzag(readVarint(&lons));
+
+        // kljucevi i vrijednosti svih cvorova, razdvojeni nulom
+        char *name = NULL;
+        while (kv.pos && kv.pos < kv.end) {
+            uint64_t k = readVarint(&kv);
+            if (k == 0) break;
+            uint64_t v = readVarint(&kv);
+            if (k < (uint64_t) numStrings && v < (uint64_t) numStrings && isNameKey(strings[k])) {
+                name = mergeName(name, strings[v]);
+            }
+        }
+
+        if (ids.error || lats.error || lons.error || kv.error) {
+            free(name);
+            blk->error = 1;
+            return;
+        }
+        blockAddNode(blk, id,
+                     1e-9 * (latOffset + granularity * lat),
+                     1e-9 * (lonOffset + granularity * lon), name);
+    }
+}
+
+static void decodeNode(PbfBlock *blk, PbfBuf msg, char **strings, int numStrings,
+                       long long granularity, long long latOffset, long long lonOffset) {
+    PbfField f;
+    PbfBuf keys = {NULL, NULL, 0}, vals = {NULL, NULL, 0};
+    long long id = 0, lat = 0, lon = 0;
+
+    while (nextField(&msg, &f)) {
+        if (f.field == 1 && f.wire == 0) id = zigzag(f.value);
+        else if (f.field == 2 && f.wire == 2) keys = f.data;
+        else if (f.field == 3 && f.wire == 2) vals = f.data;
+        else if (f.field == 8 && f.wire == 0) lat = zigzag(f.value);
+        else if (f.field == 9 && f.wire == 0) lon = zigzag(f.value);
+    }
+
+    char *name = NULL;
+    while (keys.pos && keys.pos < keys.end && vals.pos < vals.end) {
+        uint64_t k = readVarint(&keys);
+        uint64_t v = readVarint(&vals);
+        if (k < (uint64_t) numStrings && v < (uint64_t) numStrings && isNameKey(strings[k])) {
+            name = mergeName(name, strings[v]);
+        }
+    }
+    if (msg.error || keys.error || vals.error) {
+        free(name);
+        blk->error = 1;
+        return;
+    }
+    blockAddNode(blk, id,
+                 1e-9 * (latOffset + granularity * lat),
+                 1e-9 * (lonOffset + granularity * lon), name);
+}
+
+static void decodeWay(PbfBlock *blk, PbfBuf msg, char **strings, int numStrings) {
+    PbfField f;
+    PbfBuf keys = {NULL, NULL, 0}, vals = {NULL, NULL, 0}, refs = {NULL, NULL, 0};
+
+    while (nextField(&msg, &f)) {
+        if (f.wire != 2) continue;
+        if (f.field == 2) keys = f.data;
+        else if (f.field == 3) vals = f.data;
+        else if (f.field == 8) refs = f.data;
+    }
+    if (msg.error) {
+        blk->error = 1;
+        return;
+    }
+
+    int isHighway = 0;
+    char *name = NULL;
+    while (keys.pos && keys.pos < keys.end && vals.pos < vals.end) {
+        uint64_t k = readVarint(&keys);
+        uint64_t v = readVarint(&vals);
+        if (k >= (uint64_t) numStrings || v >= (uint64_t) numStrings) continue;
+        if (strcmp(strings[k], "highway") == 0) isHighway = 1;
+        if (isNameKey(strings[k])) name = mergeName(name, strings[v]);
+    }
+
+    if (!isHighway || keys.error || vals.error) {
+        free(name);
+        return;
+    }
+
+    int cap = blk->capWays;
+    blk->wayRefStart = (int*) growArray(blk->wayRefStart, &cap, blk->numWays + 2, sizeof(int));
+    cap = blk->capWays;
+    blk->wayNames = (char**) growArray(blk->wayNames, &cap, blk->numWays + 2, sizeof(char*));
+    blk->capWays = cap;
+    if (blk->numWays == 0) blk->wayRefStart[0] = 0;
+
+    long long ref = 0;
+    while (refs.pos && refs.pos < refs.end) {
+        ref += zigzag(readVarint(&refs));
+        blk->refs = (long long*) growArray(blk->refs, &blk->capRefs, blk->numRefs + 1, sizeof(long long));
+        blk->refs[blk->numRefs++] = ref;
+    }
+    if (refs.error) blk->error = 1;
+
+    blk->wayNames[blk->numWays] = name;
+    blk->numWays++;
+    blk->wayRefStart[blk->numWays] = blk->numRefs;
+}
+
+static void decodeBlock(PbfBlock *blk) {
+    size_t len = 0;
+    unsigned char *data = decodeBlob(blk->raw, blk->rawLen, &len);
+    free(blk->raw);
+    blk->raw = NULL;
+    if (!data) {
+        blk->error = 1;
+        return;
+    }
+
+    // prvi prolaz: tabela stringova i parametri koordinata
+    PbfBuf b = {data, data + len, 0};
+    PbfField f;
+    PbfBuf stringTable = {NULL, NULL, 0};
+    long long granularity = 100, latOffset = 0, lonOffset = 0;
+    while (nextField(&b, &f)) {
+        if (f.field == 1 && f.wire == 2) stringTable = f.data;
+        else if (f.field == 17 && f.wire == 0) granularity = (long long) f.value;
+        else if (f.field == 19 && f.wire == 0) latOffset = (long long) f.value;
+        else if (f.field == 20 && f.wire == 0) lonOffset = (long long) f.value;
+    }
+
+    // stringovi u PBF-u nisu zavrseni nulom, pa se kopiraju u jedan bafer
+    // (svaki string u tabeli ima bar 2 bajta zaglavlja, pa je tableLen + 1 dovoljno)
+    int numStrings = 0, capStrings = 0;
+    char **strings = NULL;
+    size_t tableLen = stringTable.pos ? (size_t) (stringTable.end - stringTable.pos) : 0;
+    char *arena = (char*) malloc(tableLen + 1);
+    size_t arenaLen = 0;
+    while (nextField(&stringTable, &f)) {
+        if (f.field != 1 || f.wire != 2) continue;
+        size_t sLen = f.data.end - f.data.pos;
+        memcpy(arena + arenaLen, f.data.pos, sLen);
+        arena[arenaLen + sLen] = '\0';
+        strings = (char**) growArray(strings, &capStrings, numStrings + 1, sizeof(char*));
+        strings[numStrings++] = arena + arenaLen;
+        arenaLen += sLen + 1;
+    }
+
+    // drugi prolaz: grupe primitiva
+    b.pos = data;
+    b.error = 0;
+    while (!blk->error && nextField(&b, &f)) {
+        if (f.field != 2 || f.wire != 2) continue;
+
+        PbfBuf group = f.data;
+        PbfField g;
+        while (!blk->error && nextField(&group, &g)) {
+            if (g.wire != 2) continue;
+            if (g.field == 1) decodeNode(blk, g.data, strings, numStrings, granularity, latOffset, lonOffset);
+            else if (g.field == 2) decodeDenseNodes(blk, g.data, strings, numStrings, granularity, latOffset, lonOffset);
+            else if (g.field == 3) decodeWay(blk, g.data, strings, numStrings);
+        }
+        if (group.error) blk->error = 1;
+    }
+    if (b.error || stringTable.error) blk->error = 1;
+
+    free(strings);
+    free(arena);
+    free(data);
+}
+
+static void* pbfWorker(void *arg) {
+    PbfWork *work = (PbfWork*) arg;
+    while (1) {
+        pthread_mutex_lock(&work->lock);
+        int i = work->nextBlock++;
+        pthread_mutex_unlock(&work->lock);
+        if (i >= work->numBlocks) break;
+        decodeBlock(&work->blocks[i]);
+    }
+    return NULL;
+}
+
+// provjerava OSMHeader blok: podrzane su samo osnovne mogucnosti formata
+static int checkHeader(const unsigned char *raw, size_t rawLen) {
+    size_t len = 0;
+    unsigned char *data = decodeBlob(raw, rawLen, &len);
+    if (!data) return -1;
+
+    int ok = 1;
+    PbfBuf b = {data, data + len, 0};
+    PbfField f;
+    while (nextField(&b, &f)) {
+        if (f.field == 4 && f.wire == 2) {
+            if (!fieldIs(&f, "OsmSchema-V0.6") && !fieldIs(&f, "DenseNodes")) {
+                fprintf(stderr, "Greska: nepodrzana PBF mogucnost \"%.*s\"\n",
+                        (int) (f.data.end - f.data.pos), f.data.pos);
+                ok = 0;
+            }
+        }
+    }
+    if (b.error) ok = 0;
+    free(data);
+    return ok ? 0 : -1;
+}
+
+static int readBigEndian32(FILE *fp, uint32_t *out) {
+    unsigned char buf[4];
+    if (fread(buf, 1, 4, fp) != 4) return 0;
+    *out = ((uint32_t) buf[0] << 24) | ((uint32_t) buf[1] << 16) | ((uint32_t) buf[2] << 8) | buf[3];
+    return 1;
+}
+
+int isPbfFile(const char *filename) {
+    size_t len = strlen(filename);
+    if (len >= 4 && strcmp(filename + len - 4, ".pbf") == 0) return 1;
+
+    // PBF pocinje duzinom zaglavlja i porukom BlobHeader sa tipom "OSMHeader"
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) return 0;
+    unsigned char buf[15];
+    size_t n = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+    return n == sizeof(buf) && buf[0] == 0 && buf[4] == 0x0a && buf[5] == 9 &&
+           memcmp(buf + 6, "OSMHeader", 9) == 0;
+}
+
+static void freeBlock(PbfBlock *blk) {
+    free(blk->raw);
+    for (int j = 0; j < blk->numNodes; j++) free(blk->nodeNames[j]);
+    for (int j = 0; j < blk->numWays; j++) free(blk->wayNames[j]);
+    free(blk->nodeIds);
+    free(blk->nodeLat);
+    free(blk->nodeLon);
+    free(blk->nodeNames);
+    free(blk->wayRefStart);
+    free(blk->wayNames);
+    free(blk->refs);
+    memset(blk, 0, sizeof(PbfBlock));
+}
+
+// paralelna dekompresija i dekodiranje jedne grupe blokova
+static int decodeBatch(PbfBlock *blocks, int numBlocks, int numThreads) {
+    PbfWork work;
+    work.blocks = blocks;
+    work.numBlocks = numBlocks;
+    work.nextBlock = 0;
+    pthread_mutex_init(&work.lock, NULL);
+
+    if (numThreads > numBlocks) numThreads = numBlocks;
+    pthread_t *threads = (pthread_t*) malloc(numThreads * sizeof(pthread_t));
+    int started = 0;
+    for (int i = 1; threads && i < numThreads; i++) {
+        if (pthread_create(&threads[started], NULL, pbfWorker, &work) == 0) started++;
+    }
+    pbfWorker(&work); // i glavna nit radi
+    for (int i = 0; i < started; i++) pthread_join(threads[i], NULL);
+    free(threads);
+    pthread_mutex_destroy(&work.lock);
+
+    for (int i = 0; i < numBlocks; i++) {
+        if (blocks[i].error) return -1;
+    }
+    return 0;
+}
+
+int parsePbfMapBatched(const char *filename, Graph *g, int batchBlocks) {
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Greska: nije moguce otvoriti fajl \"%s\"\n", filename);
+        return -1;
+    }
+
+    int numThreads = cpuCount();
+    if (batchBlocks <= 0) batchBlocks = PBF_BATCH_BLOCKS_PER_THREAD * numThreads;
+    PbfBlock *blocks = (PbfBlock*) calloc(batchBlocks, sizeof(PbfBlock));
+    unsigned char *header = (unsigned char*) malloc(MAX_HEADER_SIZE);
+    if (!blocks || !header) {
+        fprintf(stderr, "Greska: nema dovoljno memorije za PBF blokove\n");
+        free(blocks);
+        free(header);
+        fclose(fp);
+        return -1;
+    }
+
+    printf("Ucitavanje mape (PBF, %d niti, do %d blokova odjednom)...\n", numThreads, batchBlocks);
+    fflush(stdout);
+
+    int result = 0;
+    int totalBlocks = 0;
+    long long waysAdded = 0;
+    int endOfFile = 0;
+    uint32_t headerLen;
+
+    while (result == 0 && !endOfFile) {
+        // 1. sekvencijalno citanje jedne grupe blokova sa diska
+        int numBlocks = 0;
+        size_t batchBytes = 0;
+        while (numBlocks < batchBlocks && batchBytes < PBF_BATCH_BYTES) {
+            if (!readBigEndian32(fp, &headerLen)) {
+                endOfFile = 1;
+                break;
+            }
+            if (headerLen > MAX_HEADER_SIZE || fread(header, 1, headerLen, fp) != headerLen) {
+                result = -1;
+                break;
+            }
+
+            PbfBuf b = {header, header + headerLen, 0};
+            PbfField f;
+            int isHeader = 0, isData = 0;
+            uint64_t dataSize = 0;
+            while (nextField(&b, &f)) {
+                if (f.field == 1 && f.wire == 2) {
+                    isHeader = fieldIs(&f, "OSMHeader");
+                    isData = fieldIs(&f, "OSMData");
+                }
+                else if (f.field == 3 && f.wire == 0) {
+                    dataSize = f.value;
+                }
+            }
+            if (b.error || dataSize > MAX_BLOB_SIZE) {
+                result = -1;
+                break;
+            }
+
+            unsigned char *raw = (unsigned char*) malloc(dataSize ? dataSize : 1);
+            if (!raw || fread(raw, 1, dataSize, fp) != dataSize) {
+                free(raw);
+                result = -1;
+                break;
+            }
+
+            if (isHeader) {
+                if (checkHeader(raw, dataSize) != 0) result = -1;
+                free(raw);
+                if (result != 0) break;
+            }
+            else if (isData) {
+                blocks[numBlocks].raw = raw;
+                blocks[numBlocks].rawLen = dataSize;
+                numBlocks++;
+                batchBytes += dataSize;
+            }
+            else {
+                free(raw); // nepoznat tip bloka se preskace
+            }
+        }
+
+        // 2. paralelna dekompresija i dekodiranje grupe
+        if (result == 0 && numBlocks > 0) result = decodeBatch(blocks, numBlocks, numThreads);
+        totalBlocks += numBlocks;
+
+        // 3. popunjavanje grafa redom kojim su blokovi u fajlu (cvorovi prije puteva).
+        // Put se povezuje samo sa vec dodatim cvorovima, pa cvorovi iza puteva
+        // iz ranije grupe znace da fajl nije sortiran (osmium sort ga popravlja).
+        for (int i = 0; result == 0 && i < numBlocks; i++) {
+            PbfBlock *blk = &blocks[i];
+            if (blk->numNodes > 0 && waysAdded > 0) {
+                fprintf(stderr, "Greska: PBF fajl nije sortiran (cvorovi iza puteva)\n");
+                result = -1;
+                break;
+            }
+            for (int j = 0; j < blk->numNodes && result == 0; j++) {
+                result = addNode(g, blk->nodeIds[j], blk->nodeLat[j], blk->nodeLon[j], blk->nodeNames[j]);
+            }
+        }
+        for (int i = 0; result == 0 && i < numBlocks; i++) {
+            PbfBlock *blk = &blocks[i];
+            for (int j = 0; j < blk->numWays && result == 0; j++) {
+                int start = blk->wayRefStart[j];
+                result = addWayEdges(g, blk->refs + start, blk->wayRefStart[j + 1] - start, blk->wayNames[j]);
+            }
+            waysAdded += blk->numWays;
+        }
+
+        for (int i = 0; i < numBlocks; i++) freeBlock(&blocks[i]);
+    }
+
+    if (result == 0) {
+        printf("PBF: %d blokova dekodirano.\n", totalBlocks);
+    }
+    else {
+        fprintf(stderr, "Greska: neispravan PBF fajl \"%s\"\n", filename);
+    }
+
+    free(header);
+    free(blocks);
+    fclose(fp);
+    return result;
+}
+
+int parsePbfMap(const char *filename, Graph *g) {
+    return parsePbfMapBatched(filename, g, 0);
+}
@@ -0,0 +1,17 @@
+#ifndef PBF_PARSER_H
+#define PBF_PARSER_H
+
+#include "../model/graph.h"
+
+// Provjerava da li je fajl OSM PBF (po ekstenziji ili po zaglavlju prvog bloka)
+int isPbfFile(const char *filename);
+
+// Ucitava OSM PBF fajl; blokovi se dekompresuju i dekoduju paralelno, u grupama
+// koje se oslobadjaju cim su njihovi cvorovi i putevi dodati u graf.
+// Fajl mora biti sortiran (svi cvorovi prije puteva), kao sto su standardni izvozi.
+int parsePbfMap(const char *filename, Graph *g);
+
+// Isto, sa zadatom velicinom grupe u blokovima (0 = podrazumijevano, 4 po niti)
+int parsePbfMapBatched(const char *filename, Graph *g, int batchBlocks);
+
+#endif
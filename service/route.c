@@ -0,0 +1,52 @@
+#include "route.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define UNNAMED_STREET "(bez imena)"
+
+RouteSummary summarizeRoute(Graph *g, const PathResult *path) {
+    RouteSummary route = {NULL, 0};
+    if (!path->pathEdges || path->pathLength < 2) return route;
+
+    // najvise jedna deonica po ivici
+    route.segments = (RouteSegment*) malloc((path->pathLength - 1) * sizeof(RouteSegment));
+    if (!route.segments) return route;
+
+    RouteSegment *current = NULL;
+    for (int i = 1; i < path->pathLength; i++) {
+        int e = path->pathEdges[i];
+        int nameId = e == -1 ? -1 : g->edgeNameIds[e];
+        double length = e == -1 ? 0 : edgeWeight(&g->edges[e]);
+
+        if (!current || current->nameId != nameId) {
+            current = &route.segments[route.numSegments++];
+            current->nameId = nameId;
+            current->length = 0;
+            current->firstStep = i - 1;
+            current->numSteps = 0;
+        }
+        current->length += length;
+        current->numSteps++;
+    }
+    return route;
+}
+
+size_t formatRoute(Graph *g, const RouteSummary *route, char *buf, size_t size) {
+    size_t total = 0;
+    for (int i = 0; i < route->numSegments; i++) {
+        const RouteSegment *s = &route->segments[i];
+        const char *name = s->nameId == -1 ? UNNAMED_STREET : g->names[s->nameId];
+        size_t left = total < size ? size - total : 0;
+        int n = snprintf(left ? buf + total : NULL, left, "%s%s (%.0f m)",
+                         i > 0 ? " -> " : "", name, s->length);
+        if (n < 0) break;
+        total += (size_t) n;
+    }
+    if (size > 0 && route->numSegments == 0) buf[0] = '\0';
+    return total;
+}
+
+void freeRouteSummary(RouteSummary route) {
+    free(route.segments);
+}
@@ -0,0 +1,30 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+#include <stddef.h>
+#include "../model/graph.h"
+#include "pathfinder.h"
+
+// Deonica rute: uzastopne ivice putanje sa istim imenom ulice
+typedef struct RouteSegment {
+    int nameId;     // indeks u g->names ili -1 (ulica bez imena)
+    double length;  // metara
+    int firstStep;  // indeks u pathNodes na kome deonica pocinje
+    int numSteps;   // broj ivica u deonici
+} RouteSegment;
+
+typedef struct RouteSummary {
+    RouteSegment *segments;
+    int numSegments;
+} RouteSummary;
+
+// Spaja ivice iz path->pathEdges u deonice; O(duzina putanje), bez pretrage grafa
+RouteSummary summarizeRoute(Graph *g, const PathResult *path);
+
+// Kratak zapis rute u buf ("Ime (120 m) -> Ime (340 m)"); vraca potrebnu duzinu
+// bez nule na kraju, kao snprintf (buf moze biti NULL uz size 0)
+size_t formatRoute(Graph *g, const RouteSummary *route, char *buf, size_t size);
+
+void freeRouteSummary(RouteSummary route);
+
+#endif
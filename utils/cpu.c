@@ -0,0 +1,18 @@
+#include "cpu.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+int cpuCount(void) {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int) info.dwNumberOfProcessors : 1;
+}
+#else
+#include <unistd.h>
+
+int cpuCount(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int) n : 1;
+}
+#endif
@@ -0,0 +1,7 @@
+#ifndef CPU_H
+#define CPU_H
+
+// Broj logickih procesora (najmanje 1)
+int cpuCount(void);
+
+#endif
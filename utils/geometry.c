@@ -1,6 +1,12 @@
 #include "geometry.h"
 #include <math.h>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #define EARTH_RADIUS 6371000.0 // poluprecnik Zemlje u metrima
 #define TO_RAD(x) ((x) * M_PI / 180.0)
 
@@ -16,3 +22,193 @@ double calculateDistance(double lat1, double lon1, double lat2, double lon2) {
     
     return EARTH_RADIUS * c;
 }
+
+// Polinomske aproksimacije koje se mogu vektorizovati (nema poziva libm-a).
+// sin(x) za |x| <= pi/2: Tejlorov red do x^17, greska ispod 1e-11.
+#define SIN_C3  -1.6666666666666666e-01
+#define SIN_C5   8.3333333333333332e-03
+#define SIN_C7  -1.9841269841269841e-04
+#define SIN_C9   2.7557319223985893e-06
+#define SIN_C11 -2.5052108385441720e-08
+#define SIN_C13  1.6059043836821613e-10
+#define SIN_C15 -7.6471637318198164e-13
+#define SIN_C17  2.8114572543455206e-15
+
+// asin(x) za 0 <= x <= 0.5: Tejlorov red do x^29, greska ispod 1e-11.
+static const double ASIN_C[15] = {
+    1.0, 0.16666666666666666, 0.075, 0.044642857142857144,
+    0.030381944444444444, 0.022372159090909092, 0.017352764423076924,
+    0.01396484375, 0.011551800896139705, 0.009761609529194078,
+    0.008390335809616815, 0.0073125258735988454, 0.006447210311889649,
+    0.005740037670841924, 0.005153309682319905
+};
+
+static inline double polySin(double x) {
+    double x2 = x * x;
+    double p = SIN_C17;
+    p = p * x2 + SIN_C15;
+    p = p * x2 + SIN_C13;
+    p = p * x2 + SIN_C11;
+    p = p * x2 + SIN_C9;
+    p = p * x2 + SIN_C7;
+    p = p * x2 + SIN_C5;
+    p = p * x2 + SIN_C3;
+    return x + x * x2 * p;
+}
+
+// sin(x/2)^2 za |x| <= 2*pi
+static inline double polySinHalfSq(double x) {
+    double h = fabs(x) * 0.5;
+    if (h > M_PI / 2) h = M_PI - h;
+    double s = polySin(h);
+    return s * s;
+}
+
+// cos(x) za |x| <= pi/2
+static inline double polyCos(double x) {
+    return polySin(M_PI / 2 - fabs(x));
+}
+
+static inline double polyAsinSmall(double x) {
+    double x2 = x * x;
+    double p = ASIN_C[14];
+    for (int k = 13; k >= 0; k--) p = p * x2 + ASIN_C[k];
+    return x * p;
+}
+
+// asin(x) za 0 <= x <= 1
+static inline double polyAsin(double x) {
+    if (x <= 0.5) return polyAsinSmall(x);
+    return M_PI / 2 - 2 * polyAsinSmall(sqrt((1 - x) * 0.5));
+}
+
+static inline double haversineScalar(double lat1, double lon1, double lat2, double lon2) {
+    double a = polySinHalfSq(TO_RAD(lat2 - lat1)) +
+               polyCos(TO_RAD(lat1)) * polyCos(TO_RAD(lat2)) * polySinHalfSq(TO_RAD(lon2 - lon1));
+    if (a > 1) a = 1;
+    return EARTH_RADIUS * 2 * polyAsin(sqrt(a));
+}
+
+static inline double equirectScalar(double lat1, double lon1, double lat2, double lon2) {
+    double x = TO_RAD(lon2 - lon1) * polyCos(TO_RAD((lat1 + lat2) * 0.5));
+    double y = TO_RAD(lat2 - lat1);
+    return EARTH_RADIUS * sqrt(x * x + y * y);
+}
+
+// Zajednicki vektorski kod; makroi biraju AVX2 (4 double) ili SSE2 (2 double).
+#if defined(__AVX2__)
+#define VEC_WIDTH 4
+typedef __m256d vdouble;
+#define vset1(x)        _mm256_set1_pd(x)
+#define vload(p)        _mm256_loadu_pd(p)
+#define vstore(p, v)    _mm256_storeu_pd(p, v)
+#define vadd(a, b)      _mm256_add_pd(a, b)
+#define vsub(a, b)      _mm256_sub_pd(a, b)
+#define vmul(a, b)      _mm256_mul_pd(a, b)
+#define vmin(a, b)      _mm256_min_pd(a, b)
+#define vsqrt(a)        _mm256_sqrt_pd(a)
+#define vabs(a)         _mm256_andnot_pd(_mm256_set1_pd(-0.0), a)
+#define vgt(a, b)       _mm256_cmp_pd(a, b, _CMP_GT_OQ)
+#define vselect(m, a, b) _mm256_blendv_pd(b, a, m)
+#elif defined(__SSE2__)
+#define VEC_WIDTH 2
+typedef __m128d vdouble;
+#define vset1(x)        _mm_set1_pd(x)
+#define vload(p)        _mm_loadu_pd(p)
+#define vstore(p, v)    _mm_storeu_pd(p, v)
+#define vadd(a, b)      _mm_add_pd(a, b)
+#define vsub(a, b)      _mm_sub_pd(a, b)
+#define vmul(a, b)      _mm_mul_pd(a, b)
+#define vmin(a, b)      _mm_min_pd(a, b)
+#define vsqrt(a)        _mm_sqrt_pd(a)
+#define vabs(a)         _mm_andnot_pd(_mm_set1_pd(-0.0), a)
+#define vgt(a, b)       _mm_cmpgt_pd(a, b)
+#define vselect(m, a, b) _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b))
+#endif
+
+#ifdef VEC_WIDTH
+static inline vdouble vpolySin(vdouble x) {
+    vdouble x2 = vmul(x, x);
+    vdouble p = vset1(SIN_C17);
+    p = vadd(vmul(p, x2), vset1(SIN_C15));
+    p = vadd(vmul(p, x2), vset1(SIN_C13));
+    p = vadd(vmul(p, x2), vset1(SIN_C11));
+    p = vadd(vmul(p, x2), vset1(SIN_C9));
+    p = vadd(vmul(p, x2), vset1(SIN_C7));
+    p = vadd(vmul(p, x2), vset1(SIN_C5));
+    p = vadd(vmul(p, x2), vset1(SIN_C3));
+    return vadd(x, vmul(vmul(x, x2), p));
+}
+
+static inline vdouble vpolySinHalfSq(vdouble x) {
+    vdouble h = vmul(vabs(x), vset1(0.5));
+    vdouble halfPi = vset1(M_PI / 2);
+    h = vselect(vgt(h, halfPi), vsub(vset1(M_PI), h), h);
+    vdouble s = vpolySin(h);
+    return vmul(s, s);
+}
+
+static inline vdouble vpolyCos(vdouble x) {
+    return vpolySin(vsub(vset1(M_PI / 2), vabs(x)));
+}
+
+static inline vdouble vpolyAsinSmall(vdouble x) {
+    vdouble x2 = vmul(x, x);
+    vdouble p = vset1(ASIN_C[14]);
+    for (int k = 13; k >= 0; k--) p = vadd(vmul(p, x2), vset1(ASIN_C[k]));
+    return vmul(x, p);
+}
+
+static inline vdouble vpolyAsin(vdouble x) {
+    vdouble small = vpolyAsinSmall(x);
+    vdouble r = vsqrt(vmul(vsub(vset1(1.0), x), vset1(0.5)));
+    vdouble large = vsub(vset1(M_PI / 2), vmul(vset1(2.0), vpolyAsinSmall(r)));
+    return vselect(vgt(x, vset1(0.5)), large, small);
+}
+#endif
+
+void calculateDistanceBatch(const double *lat1, const double *lon1,
+                            const double *lat2, const double *lon2, double *out, int n) {
+    int i = 0;
+#ifdef VEC_WIDTH
+    vdouble toRad = vset1(M_PI / 180.0);
+    for (; i + VEC_WIDTH <= n; i += VEC_WIDTH) {
+        vdouble la1 = vmul(vload(lat1 + i), toRad);
+        vdouble la2 = vmul(vload(lat2 + i), toRad);
+        vdouble dLon = vmul(vsub(vload(lon2 + i), vload(lon1 + i)), toRad);
+
+        vdouble a = vadd(vpolySinHalfSq(vsub(la2, la1)),
+                         vmul(vmul(vpolyCos(la1), vpolyCos(la2)), vpolySinHalfSq(dLon)));
+        a = vmin(a, vset1(1.0));
+
+        vdouble c = vmul(vset1(2.0 * EARTH_RADIUS), vpolyAsin(vsqrt(a)));
+        vstore(out + i, c);
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = haversineScalar(lat1[i], lon1[i], lat2[i], lon2[i]);
+    }
+}
+
+double approximateDistance(double lat1, double lon1, double lat2, double lon2) {
+    return equirectScalar(lat1, lon1, lat2, lon2);
+}
+
+void approximateDistanceBatch(const double *lat1, const double *lon1,
+                              const double *lat2, const double *lon2, double *out, int n) {
+    int i = 0;
+#ifdef VEC_WIDTH
+    vdouble toRad = vset1(M_PI / 180.0);
+    for (; i + VEC_WIDTH <= n; i += VEC_WIDTH) {
+        vdouble la1 = vload(lat1 + i);
+        vdouble la2 = vload(lat2 + i);
+        vdouble midLat = vmul(vmul(vadd(la1, la2), vset1(0.5)), toRad);
+        vdouble x = vmul(vmul(vsub(vload(lon2 + i), vload(lon1 + i)), toRad), vpolyCos(midLat));
+        vdouble y = vmul(vsub(la2, la1), toRad);
+        vstore(out + i, vmul(vset1(EARTH_RADIUS), vsqrt(vadd(vmul(x, x), vmul(y, y)))));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = equirectScalar(lat1[i], lon1[i], lat2[i], lon2[i]);
+    }
+}
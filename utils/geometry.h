@@ -3,4 +3,24 @@
 
 double calculateDistance(double lat1, double lon1, double lat2, double lon2);
 
+// Haversinus za n parova tacaka odjednom: out[i] = calculateDistance(lat1[i], lon1[i], lat2[i], lon2[i]).
+// Koristi AVX2 ili SSE2 (zavisno od flagova kompajlera), inace skalarnu petlju.
+// Odstupanje od calculateDistance je ispod 1e-9 relativno.
+void calculateDistanceBatch(const double *lat1, const double *lon1,
+                            const double *lat2, const double *lon2, double *out, int n);
+
+// Granice relativne greske approximateDistance naspram calculateDistance oko Beograda
+// (44.8N, 20.46E); greska raste sa kvadratom duzine, pa je najveca za najdalje parove.
+// ./bench geometry provjerava sve tri granice.
+#define APPROX_ERROR_CIRCLE  1.1e-5 // krug od 0.5 stepeni (najvise ~1e-5, oko 1m na 90km)
+#define APPROX_ERROR_BOX     2e-5   // kvadrat +-0.5 stepeni (uglovi, do ~130km)
+#define APPROX_ERROR_SEGMENT 1e-8   // segmenti ulica (< 1km)
+
+// Ekvirektangularna aproksimacija (Pitagora na ravni sa kosinusom srednje sirine).
+// Greska: vidi APPROX_ERROR_* iznad.
+double approximateDistance(double lat1, double lon1, double lat2, double lon2);
+
+void approximateDistanceBatch(const double *lat1, const double *lon1,
+                              const double *lat2, const double *lon2, double *out, int n);
+
 #endif
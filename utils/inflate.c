@@ -0,0 +1,248 @@
+#include "inflate.h"
+#include <string.h>
+#include <stdint.h>
+
+// Jednostavan deflate dekoder (po uzoru na "puff" iz zlib-a), bez spoljnih biblioteka.
+
+#define MAX_BITS 15
+#define MAX_LCODES 286
+#define MAX_DCODES 30
+#define FIX_LCODES 288
+
+typedef struct {
+    const unsigned char *pos;
+    const unsigned char *end;
+    uint32_t bitBuf;
+    int bitCount;
+    unsigned char *out;
+    size_t outLen;
+    size_t outCap;
+    int error;
+} InflateState;
+
+typedef struct {
+    short count[MAX_BITS + 1]; // broj kodova za svaku duzinu
+    short symbol[FIX_LCODES];  // simboli poredani po kanonskom kodu
+} Huffman;
+
+static const short LEN_BASE[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const short LEN_EXTRA[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const short DIST_BASE[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+static const short DIST_EXTRA[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static int getBits(InflateState *s, int n) {
+    uint32_t val = s->bitBuf;
+    while (s->bitCount < n) {
+        if (s->pos == s->end) {
+            s->error = 1;
+            return 0;
+        }
+        val |= (uint32_t) *s->pos++ << s->bitCount;
+        s->bitCount += 8;
+    }
+    s->bitBuf = val >> n;
+    s->bitCount -= n;
+    return (int) (val & ((1u << n) - 1));
+}
+
+// gradi kanonski Huffmanov kod iz duzina; vraca -1 za predefinisan kod
+static int buildHuffman(Huffman *h, const short *lengths, int n) {
+    short offs[MAX_BITS + 1];
+
+    for (int len = 0; len <= MAX_BITS; len++) h->count[len] = 0;
+    for (int sym = 0; sym < n; sym++) h->count[lengths[sym]]++;
+    if (h->count[0] == n) return 0;
+
+    int left = 1;
+    for (int len = 1; len <= MAX_BITS; len++) {
+        left <<= 1;
+        left -= h->count[len];
+        if (left < 0) return -1;
+    }
+
+    offs[1] = 0;
+    for (int len = 1; len < MAX_BITS; len++) offs[len + 1] = offs[len] + h->count[len];
+    for (int sym = 0; sym < n; sym++) {
+        if (lengths[sym] != 0) h->symbol[offs[lengths[sym]]++] = (short) sym;
+    }
+    return left;
+}
+
+static int decodeSymbol(InflateState *s, const Huffman *h) {
+    int code = 0, first = 0, index = 0;
+    for (int len = 1; len <= MAX_BITS; len++) {
+        code |= getBits(s, 1);
+        if (s->error) return -1;
+        int count = h->count[len];
+        if (code - count < first) return h->symbol[index + (code - first)];
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static int inflateStored(InflateState *s) {
+    s->bitBuf = 0;
+    s->bitCount = 0;
+    if (s->end - s->pos < 4) return -1;
+
+    unsigned len = s->pos[0] | (s->pos[1] << 8);
+    unsigned nlen = s->pos[2] | (s->pos[3] << 8);
+    s->pos += 4;
+    if (len != (~nlen & 0xffff)) return -1;
+    if ((size_t) (s->end - s->pos) < len || s->outCap - s->outLen < len) return -1;
+
+    memcpy(s->out + s->outLen, s->pos, len);
+    s->pos += len;
+    s->outLen += len;
+    return 0;
+}
+
+static int inflateCodes(InflateState *s, const Huffman *lencode, const Huffman *distcode) {
+    while (1) {
+        int sym = decodeSymbol(s, lencode);
+        if (sym < 0) return -1;
+
+        if (sym < 256) {
+            if (s->outLen == s->outCap) return -1;
+            s->out[s->outLen++] = (unsigned char) sym;
+        }
+        else if (sym == 256) {
+            return 0;
+        }
+        else {
+            sym -= 257;
+            if (sym >= 29) return -1;
+            size_t len = LEN_BASE[sym] + getBits(s, LEN_EXTRA[sym]);
+
+            int dsym = decodeSymbol(s, distcode);
+            if (dsym < 0 || dsym >= 30) return -1;
+            size_t dist = DIST_BASE[dsym] + getBits(s, DIST_EXTRA[dsym]);
+            if (s->error || dist > s->outLen || s->outCap - s->outLen < len) return -1;
+
+            // kopiranje bajt po bajt jer se izvor i odrediste mogu preklapati
+            unsigned char *dst = s->out + s->outLen;
+            const unsigned char *src = dst - dist;
+            for (size_t i = 0; i < len; i++) dst[i] = src[i];
+            s->outLen += len;
+        }
+    }
+}
+
+static int inflateFixed(InflateState *s) {
+    short lengths[FIX_LCODES];
+    Huffman lencode, distcode;
+
+    // tabele su male, pa se grade na steku (bez dijeljenog stanja izmedju niti)
+    int sym = 0;
+    for (; sym < 144; sym++) lengths[sym] = 8;
+    for (; sym < 256; sym++) lengths[sym] = 9;
+    for (; sym < 280; sym++) lengths[sym] = 7;
+    for (; sym < FIX_LCODES; sym++) lengths[sym] = 8;
+    buildHuffman(&lencode, lengths, FIX_LCODES);
+    for (sym = 0; sym < MAX_DCODES; sym++) lengths[sym] = 5;
+    buildHuffman(&distcode, lengths, MAX_DCODES);
+
+    return inflateCodes(s, &lencode, &distcode);
+}
+
+static int inflateDynamic(InflateState *s) {
+    static const short ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+    short lengths[MAX_LCODES + MAX_DCODES];
+    Huffman lencode, distcode;
+
+    int nlen = getBits(s, 5) + 257;
+    int ndist = getBits(s, 5) + 1;
+    int ncode = getBits(s, 4) + 4;
+    if (s->error || nlen > MAX_LCODES || ndist > MAX_DCODES) return -1;
+
+    int index;
+    for (index = 0; index < ncode; index++) lengths[ORDER[index]] = (short) getBits(s, 3);
+    for (; index < 19; index++) lengths[ORDER[index]] = 0;
+    if (s->error || buildHuffman(&lencode, lengths, 19) != 0) return -1;
+
+    index = 0;
+    while (index < nlen + ndist) {
+        int sym = decodeSymbol(s, &lencode);
+        if (sym < 0) return -1;
+        if (sym < 16) {
+            lengths[index++] = (short) sym;
+        }
+        else {
+            short len = 0;
+            int repeat;
+            if (sym == 16) {
+                if (index == 0) return -1;
+                len = lengths[index - 1];
+                repeat = 3 + getBits(s, 2);
+            }
+            else if (sym == 17) {
+                repeat = 3 + getBits(s, 3);
+            }
+            else {
+                repeat = 11 + getBits(s, 7);
+            }
+            if (s->error || index + repeat > nlen + ndist) return -1;
+            while (repeat--) lengths[index++] = len;
+        }
+    }
+    if (lengths[256] == 0) return -1;
+
+    // nepotpuni kodovi su dozvoljeni samo ako imaju jedan simbol
+    int err = buildHuffman(&lencode, lengths, nlen);
+    if (err < 0 || (err > 0 && nlen - lencode.count[0] != 1)) return -1;
+    err = buildHuffman(&distcode, lengths + nlen, ndist);
+    if (err < 0 || (err > 0 && ndist - distcode.count[0] != 1)) return -1;
+
+    return inflateCodes(s, &lencode, &distcode);
+}
+
+long inflateZlib(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstLen) {
+    if (srcLen < 2) return -1;
+
+    // zlib zaglavlje: metoda 8 (deflate), bez rjecnika
+    int cmf = src[0], flg = src[1];
+    if ((cmf & 0x0f) != 8 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20)) return -1;
+
+    InflateState s;
+    s.pos = src + 2;
+    s.end = src + srcLen;
+    s.bitBuf = 0;
+    s.bitCount = 0;
+    s.out = dst;
+    s.outLen = 0;
+    s.outCap = dstLen;
+    s.error = 0;
+
+    int last;
+    do {
+        last = getBits(&s, 1);
+        int type = getBits(&s, 2);
+        if (s.error) return -1;
+
+        int err;
+        if (type == 0) err = inflateStored(&s);
+        else if (type == 1) err = inflateFixed(&s);
+        else if (type == 2) err = inflateDynamic(&s);
+        else err = -1;
+
+        if (err != 0 || s.error) return -1;
+    } while (!last);
+
+    return (long) s.outLen;
+}
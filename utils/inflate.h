@@ -0,0 +1,10 @@
+#ifndef INFLATE_H
+#define INFLATE_H
+
+#include <stddef.h>
+
+// Dekompresuje zlib tok (RFC 1950/1951) iz src u dst.
+// Vraca broj upisanih bajtova ili -1 ako su podaci neispravni ili dst premali.
+long inflateZlib(const unsigned char *src, size_t srcLen, unsigned char *dst, size_t dstLen);
+
+#endif
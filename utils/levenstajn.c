@@ -1,7 +1,6 @@
 #include "levenstajn.h"
 #include <string.h>
 #include <stdlib.h>
-#include <ctype.h>
 
 static int min3(int a, int b, int c) {
     int m = a;
@@ -25,7 +24,7 @@ int levenshtein_distance(const char *s1, const char *s2) {
     for (int i = 1; i <= len1; i++) {
         for (int j = 1; j <= len2; j++) {
             
-            int cost = (tolower(s1[i - 1]) == tolower(s2[j - 1])) ? 0 : 1;
+            int cost = (s1[i - 1] == s2[j - 1]) ? 0 : 1;
             
             matrix[i][j] = min3(
                 matrix[i - 1][j] + 1,      // brisanje
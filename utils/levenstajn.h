@@ -1,6 +1,7 @@
 #ifndef LEVENSTAJN_H
 #define LEVENSTAJN_H
 
+// Poredi bajt po bajt; za imena se pozivaju normalizovani kljucevi (utils/normalize.h)
 int levenshtein_distance(const char *s1, const char *s2);
 
 #endif
@@ -0,0 +1,152 @@
+#include "normalize.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Osnovno slovo za U+00C0 - U+017F (Latin-1 i Latin Extended-A); '*' = ostavi znak kakav jeste.
+// Slova koja se pisu sa dva znaka (dj, ae, ss...) rjesava latinDigraph.
+static const char latinBase[] =
+    "aaaaaaaceeeeiiiidnooooo*ouuuuyts"  // C0 - DF
+    "aaaaaaaceeeeiiiidnooooo*ouuuuyty"  // E0 - FF
+    "aaaaaaccccccccddddeeeeeeeeeegggg"  // 100 - 11F
+    "gggghhhhiiiiiiiiiiiijjkkklllllll"  // 120 - 13F
+    "lllnnnnnnnnnoooooooorrrrrrssssss"  // 140 - 15F
+    "ssttttttuuuuuuuuuuuuwwyyyzzzzzzs"; // 160 - 17F
+
+static const char* latinDigraph(unsigned int cp) {
+    switch (cp) {
+        case 0x110: case 0x111: return "dj"; // Đ đ
+        case 0xC6: case 0xE6: return "ae";
+        case 0xDE: case 0xFE: return "th";
+        case 0xDF: return "ss";
+        case 0x132: case 0x133: return "ij";
+        case 0x152: case 0x153: return "oe";
+        default: return NULL;
+    }
+}
+
+// Latinica za mala cirilicna slova U+0430 - U+045F (srpska azbuka i ostala cesta slova)
+static const char *cyrillic[48] = {
+    "a", "b", "v", "g", "d", "e", "z", "z", "i", "j", "k", "l", "m", "n", "o", "p",      // а - п
+    "r", "s", "t", "u", "f", "h", "c", "c", "s", "sc", "", "y", "", "e", "ju", "ja",     // р - я
+    "e", "e", "dj", "g", "je", "dz", "i", "ji", "j", "lj", "nj", "c", "k", "i", "u", "dz" // ѐ - џ
+};
+
+#define INVALID_CODEPOINT 0xFFFFFFFFu
+
+// Malo slovo za pisma koja se ne preslovljavaju (grcki, ostatak cirilice, jermenski,
+// Latin Extended Additional); mala i velika slova su u istom UTF-8 opsegu duzine.
+// Ostali znakovi (npr. Latin Extended-B, gruzijski) se vracaju nepromijenjeni.
+static unsigned int foldCase(unsigned int cp) {
+    if (cp >= 0x391 && cp <= 0x3AB && cp != 0x3A2) return cp + 0x20; // Α - Ϋ
+    switch (cp) {
+        case 0x386: return 0x3AC;                                 // Ά
+        case 0x388: case 0x389: case 0x38A: return cp + 0x25;     // Έ Ή Ί
+        case 0x38C: return 0x3CC;                                 // Ό
+        case 0x38E: case 0x38F: return cp + 0x3F;                 // Ύ Ώ
+        case 0x3C2: return 0x3C3;                                 // ς -> σ
+        case 0x4C0: return 0x4CF;                                 // Ӏ
+    }
+    if (cp >= 0x3D8 && cp <= 0x3EF) return cp | 1;               // arhaicna grcka slova, koptski
+    if ((cp >= 0x460 && cp <= 0x481) || (cp >= 0x48A && cp <= 0x4BF) ||
+        (cp >= 0x4D0 && cp <= 0x52F)) return cp | 1;             // parovi velikog (parnog) i malog slova
+    if (cp >= 0x4C1 && cp <= 0x4CE) return (cp & 1) ? cp + 1 : cp; // ovdje je veliko slovo neparno
+    if (cp >= 0x531 && cp <= 0x556) return cp + 0x30;            // jermenski
+    if ((cp >= 0x1E00 && cp <= 0x1E95) || (cp >= 0x1EA0 && cp <= 0x1EFF)) return cp | 1;
+    return cp;
+}
+
+// upisuje cp u UTF-8 (2 ili 3 bajta, dovoljno za foldCase); vraca broj bajtova
+static size_t encodeUtf8(unsigned int cp, char *dst) {
+    if (cp < 0x800) {
+        dst[0] = (char) (0xC0 | (cp >> 6));
+        dst[1] = (char) (0x80 | (cp & 0x3F));
+        return 2;
+    }
+    dst[0] = (char) (0xE0 | (cp >> 12));
+    dst[1] = (char) (0x80 | ((cp >> 6) & 0x3F));
+    dst[2] = (char) (0x80 | (cp & 0x3F));
+    return 3;
+}
+
+// dekodira jedan UTF-8 znak; neispravan niz je jedan bajt koji se prepisuje kakav jeste
+static unsigned int decodeUtf8(const unsigned char *s, size_t len, size_t *used) {
+    unsigned int c = s[0];
+    int extra = 0;
+    if (c >= 0xC0 && c < 0xE0) { extra = 1; c &= 0x1F; }
+    else if (c >= 0xE0 && c < 0xF0) { extra = 2; c &= 0x0F; }
+    else if (c >= 0xF0 && c < 0xF8) { extra = 3; c &= 0x07; }
+
+    if (extra == 0 || (size_t) extra >= len) {
+        *used = 1;
+        return INVALID_CODEPOINT;
+    }
+    for (int i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *used = 1;
+            return INVALID_CODEPOINT;
+        }
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    *used = extra + 1;
+    return c;
+}
+
+size_t normalizeName(const char *src, size_t len, char *dst) {
+    const unsigned char *s = (const unsigned char*) src;
+    size_t in = 0, out = 0;
+    while (in < len) {
+        // ASCII: samo mala slova
+        if (s[in] < 0x80) {
+            char c = (char) s[in++];
+            if (c >= 'A' && c <= 'Z') c += 32;
+            dst[out++] = c;
+            continue;
+        }
+
+        size_t used;
+        unsigned int cp = decodeUtf8(s + in, len - in, &used);
+        const char *repl = NULL;
+        char single[2] = {0, 0};
+
+        if (cp >= 0x300 && cp <= 0x36F) {
+            repl = ""; // kombinujuci dijakritik (rastavljeni oblik)
+        }
+        else if (cp >= 0xC0 && cp <= 0x17F) {
+            repl = latinDigraph(cp);
+            if (!repl && latinBase[cp - 0xC0] != '*') {
+                single[0] = latinBase[cp - 0xC0];
+                repl = single;
+            }
+        }
+        else if (cp >= 0x400 && cp <= 0x45F) {
+            if (cp < 0x410) cp += 0x50;      // Ѐ - Џ
+            else if (cp < 0x430) cp += 0x20; // А - Я
+            repl = cyrillic[cp - 0x430];
+        }
+
+        if (repl) {
+            // zamjena je uvijek kraca ili jednaka UTF-8 zapisu
+            size_t n = strlen(repl);
+            memcpy(dst + out, repl, n);
+            out += n;
+        }
+        else if (cp != INVALID_CODEPOINT && foldCase(cp) != cp) {
+            out += encodeUtf8(foldCase(cp), dst + out);
+        }
+        else {
+            memcpy(dst + out, s + in, used);
+            out += used;
+        }
+        in += used;
+    }
+    dst[out] = '\0';
+    return out;
+}
+
+char* createNameKey(const char *name) {
+    if (!name) return NULL;
+    size_t len = strlen(name);
+    char *key = (char*) malloc(len + 1);
+    if (key) normalizeName(name, len, key);
+    return key;
+}
@@ -0,0 +1,19 @@
+#ifndef NORMALIZE_H
+#define NORMALIZE_H
+
+#include <stddef.h>
+
+// Kljuc imena za pretragu: mala slova, bez dijakritika (c/c/s/z, d -> dj),
+// cirilica preslovljena u latinicu (Кнеза Милоша -> kneza milosa).
+// Tako se "Đure Đakovića", "Djure Djakovica" i "Ђуре Ђаковића" svode na isti kljuc.
+// Nije potpuno Unicode case folding (CaseFolding.txt): velika slova se izjednacavaju
+// sa malim za ASCII, Latin-1 i Latin Extended-A (U+00C0 - 017F, i bez dijakritika),
+// cirilicu (U+0400 - 052F), grcki, jermenski i Latin Extended Additional (U+1E00 - 1EFF).
+// Ostala pisma (npr. Latin Extended-B, gruzijski) ostaju kakva jesu.
+// Kljuc nikad nije duzi od ulaza: dst mora imati bar len + 1 bajt. Vraca duzinu kljuca.
+size_t normalizeName(const char *src, size_t len, char *dst);
+
+// Novi normalizovan kljuc (malloc) ili NULL za NULL
+char* createNameKey(const char *name);
+
+#endif
@@ -0,0 +1,108 @@
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+    ThreadPool *pool;
+    int threadId;
+} WorkerArg;
+
+static void barrierInit(PoolBarrier *b, int count) {
+    pthread_mutex_init(&b->lock, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->count = count;
+    b->waiting = 0;
+    b->generation = 0;
+}
+
+static void barrierWait(PoolBarrier *b) {
+    pthread_mutex_lock(&b->lock);
+    int generation = b->generation;
+    if (++b->waiting == b->count) {
+        b->waiting = 0;
+        b->generation++;
+        pthread_cond_broadcast(&b->cond);
+    }
+    else {
+        while (generation == b->generation) {
+            pthread_cond_wait(&b->cond, &b->lock);
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+static void* worker(void *arg) {
+    WorkerArg *w = (WorkerArg*) arg;
+    ThreadPool *pool = w->pool;
+    int threadId = w->threadId;
+    free(w);
+
+    while (1) {
+        barrierWait(&pool->barrier); // cekaj posao
+        if (pool->shutdown) break;
+        pool->task(pool->arg, threadId, pool->numThreads);
+        barrierWait(&pool->barrier); // posao zavrsen
+    }
+    return NULL;
+}
+
+ThreadPool* createThreadPool(int numThreads) {
+    if (numThreads < 1) numThreads = 1;
+
+    ThreadPool *pool = (ThreadPool*) malloc(sizeof(ThreadPool));
+    pool->numThreads = numThreads;
+    pool->threads = (pthread_t*) malloc(numThreads * sizeof(pthread_t));
+    pool->task = NULL;
+    pool->arg = NULL;
+    pool->shutdown = 0;
+    barrierInit(&pool->barrier, numThreads);
+
+    int started = 1; // pozivalac je nit 0
+    while (started < numThreads) {
+        WorkerArg *w = (WorkerArg*) malloc(sizeof(WorkerArg));
+        if (!w) break;
+        w->pool = pool;
+        w->threadId = started;
+        if (pthread_create(&pool->threads[started], NULL, worker, w) != 0) {
+            free(w);
+            break;
+        }
+        started++;
+    }
+
+    // barijera ocekuje sve niti: bazen radi sa onoliko niti koliko je pokrenuto
+    // (pokrenuti radnici vec mogu cekati na barijeri, pa se broj mijenja pod bravom)
+    if (started < numThreads) {
+        fprintf(stderr, "Greska: pokrenuto %d od %d niti\n", started, numThreads);
+        pthread_mutex_lock(&pool->barrier.lock);
+        pool->barrier.count = started;
+        pool->numThreads = started;
+        pthread_mutex_unlock(&pool->barrier.lock);
+    }
+    return pool;
+}
+
+void runOnPool(ThreadPool *pool, PoolTask task, void *arg) {
+    pool->task = task;
+    pool->arg = arg;
+    if (pool->numThreads > 1) barrierWait(&pool->barrier);
+    task(arg, 0, pool->numThreads);
+    if (pool->numThreads > 1) barrierWait(&pool->barrier);
+}
+
+void poolBarrier(ThreadPool *pool) {
+    if (pool->numThreads > 1) barrierWait(&pool->barrier);
+}
+
+void freeThreadPool(ThreadPool *pool) {
+    if (!pool) return;
+    pool->shutdown = 1;
+    if (pool->numThreads > 1) barrierWait(&pool->barrier);
+    for (int i = 1; i < pool->numThreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&pool->barrier.lock);
+    pthread_cond_destroy(&pool->barrier.cond);
+    free(pool->threads);
+    free(pool);
+}
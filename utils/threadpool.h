@@ -0,0 +1,38 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <pthread.h>
+
+// Zadatak koji izvrsavaju sve niti bazena; threadId je od 0 do numThreads - 1
+typedef void (*PoolTask)(void *arg, int threadId, int numThreads);
+
+typedef struct PoolBarrier {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int count;
+    int waiting;
+    int generation;
+} PoolBarrier;
+
+// Bazen niti koje cekaju posao; pozivalac je nit 0, a bazen ima numThreads - 1 radnika
+typedef struct ThreadPool {
+    int numThreads;
+    pthread_t *threads;
+    PoolBarrier barrier;
+    PoolTask task;
+    void *arg;
+    int shutdown;
+} ThreadPool;
+
+// Ako se neka nit ne moze pokrenuti, bazen radi sa manje niti (pool->numThreads)
+ThreadPool* createThreadPool(int numThreads);
+
+// Izvrsava zadatak na svim nitima i ceka da sve zavrse
+void runOnPool(ThreadPool *pool, PoolTask task, void *arg);
+
+// Sinhronizacija svih niti unutar zadatka
+void poolBarrier(ThreadPool *pool);
+
+void freeThreadPool(ThreadPool *pool);
+
+#endif
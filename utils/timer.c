@@ -0,0 +1,20 @@
+#include "timer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+double nowMs(void) {
+    LARGE_INTEGER freq, counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double) counter.QuadPart * 1000.0 / (double) freq.QuadPart;
+}
+#else
+#include <time.h>
+
+double nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+#endif
@@ -0,0 +1,7 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+// Monotono vrijeme u milisekundama (za mjerenje i rokove)
+double nowMs(void);
+
+#endif